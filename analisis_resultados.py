@@ -1,6 +1,13 @@
+import os
 import pandas as pd
 
-stats = ["mean", "std"] # Las estadísticas que vamos a sacar
+# Percentiles con nombre para que salgan como columnas en el resultado
+def p90(x):
+    return x.quantile(0.9)
+def p99(x):
+    return x.quantile(0.99)
+
+stats = ["mean", "std", "median", p90, p99] # Las estadísticas que vamos a sacar
 # Polinomials results headers
 statistics_csv = "analisis_datos/statistics_backup.csv"
 statistics_time_labels = ["T_polinomio", "T_NTT", "T_suma", "T_multiplicacion", "T_INTT"]
@@ -8,10 +15,13 @@ statistics_group_labels = ["Libreria", "Tamano_Mod"]
 # HE results headers
 he_scheme_csv = "analisis_datos/he_schemes_backup.csv"
 he_scheme_time_labels = ["T_keygen", "T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado", "T_context"]
-he_scheme_group_labels = ["Libreria", "Sec_Level"]
+he_scheme_group_labels = ["Libreria", "Sec_Level", "Esquema"] # OpenFHE mide BGV, BFV y CKKS
 # Cargamos datos
 df_polynomials = pd.read_csv(statistics_csv)
 df_fheschemes = pd.read_csv(he_scheme_csv)
+# Las copias anteriores a la columna Esquema son de FV (NFLlib) y BGV (OpenFHE y HElib)
+if "Esquema" not in df_fheschemes.columns:
+    df_fheschemes.insert(3, "Esquema", df_fheschemes["Libreria"].map(lambda libreria: "FV" if libreria.startswith("nfllib") else "BGV"))
 # Convertimos los tiempos a float si no lo están
 df_polynomials[statistics_time_labels] = df_polynomials[statistics_time_labels].astype(float)
 df_fheschemes[he_scheme_time_labels] = df_fheschemes[he_scheme_time_labels].astype(float)
@@ -32,4 +42,63 @@ print(fheschemes_stats)
 
 # Si quieres guardarlo en un CSV
 polynomial_stats.to_csv("estadisticos_polinomios.csv")
-fheschemes_stats.to_csv("estadisticos_esquemasFHE.csv")
\ No newline at end of file
+fheschemes_stats.to_csv("estadisticos_esquemasFHE.csv")
+
+# Resúmenes que escriben los benchmarks (include/benchmark.h), sin las
+# iteraciones de calentamiento y con el intervalo de confianza de la mediana
+resumenes = {"statistics_resumen.csv": statistics_group_labels, "he_schemes_resumen.csv": he_scheme_group_labels,
+             "backend_resumen.csv": ["Libreria", "Sec_Level"], "he_cache_resumen.csv": ["Libreria", "Sec_Level"]}
+for resumen_csv, group_labels in resumenes.items():
+    if os.path.exists(resumen_csv):
+        df_resumen = pd.read_csv(resumen_csv)
+        print("Resumen de " + resumen_csv)
+        print(df_resumen.set_index(group_labels + ["Fase"])[["N", "Mediana", "IC95_inf", "IC95_sup", "P90", "P99", "Atipicos", "Mediana_ciclos"]])
+        # Contadores hardware (solo si se ha ejecutado con BENCH_PERF=1)
+        if df_resumen["Instrucciones"].notna().any():
+            df_resumen["IPC"] = df_resumen["Instrucciones"] / df_resumen["Ciclos_hw"]
+            print(df_resumen.set_index(group_labels + ["Fase"])[["IPC", "Fallos_L1D", "Fallos_LLC", "Fallos_salto", "Fallos_DTLB"]])
+        # Coste amortizado por elemento útil del texto plano (benchmarks de esquemas)
+        if df_resumen["Elementos"].notna().any():
+            print(df_resumen.set_index(group_labels + ["Fase"])[["Elementos", "Ranuras", "Grado", "Mediana", "Mediana_por_elemento"]])
+        # Memoria (solo si se ha ejecutado con BENCH_MEMORIA=1)
+        if df_resumen["Pico_RSS_kB"].notna().any():
+            print(df_resumen.set_index(group_labels + ["Fase"])[["Reservas", "Bytes_reservados", "Pico_heap", "Pico_RSS_kB"]])
+
+# Tamaño serializado de contexto, claves y criptogramas
+if os.path.exists("tamanos.csv"):
+    df_tamanos = pd.read_csv("tamanos.csv")
+    print("Tamaños serializados (bytes)")
+    print(df_tamanos.pivot_table(index=["Libreria", "Sec_Level"], columns="Objeto", values="Bytes"))
+
+# Benchmark común (include/backend.h): mediana de cada fase, una columna por librería
+if os.path.exists("backend_resumen.csv"):
+    df_backend = pd.read_csv("backend_resumen.csv")
+    print("Mismas fases en las tres librerías (mediana, us)")
+    print(df_backend.pivot_table(index=["Sec_Level", "Fase"], columns="Libreria", values="Mediana"))
+
+# Arranque en frío y en caliente con la caché de claves (include/cache_claves.h)
+if os.path.exists("he_cache_resumen.csv"):
+    df_cache = pd.read_csv("he_cache_resumen.csv").pivot_table(index=["Libreria", "Sec_Level"], columns="Fase", values="Mediana")
+    df_cache["Aceleracion"] = df_cache["T_frio"] / df_cache["T_caliente"]
+    print("Arranque sin caché y con caché (mediana, us)")
+    print(df_cache)
+
+# Barrido de hilos de OpenMP en OpenFHE: aceleración de cada fase frente a un hilo
+if os.path.exists("openfhe_hilos_resumen.csv"):
+    df_hilos = pd.read_csv("openfhe_hilos_resumen.csv").pivot_table(index=["Sec_Level", "Fase"], columns="Hilos", values="Mediana")
+    print("Aceleración de OpenFHE con los hilos de OpenMP")
+    print(df_hilos.rdiv(df_hilos[1], axis=0))
+
+# Curva de coste por nivel (include/profundidad.h): mediana del tiempo y del
+# presupuesto de ruido de cada nivel y último nivel que descifra bien
+if os.path.exists("profundidad.csv"):
+    df_profundidad = pd.read_csv("profundidad.csv")
+    print("Coste y ruido por nivel de profundidad")
+    print(df_profundidad.groupby(["Libreria", "Sec_Level", "Circuito", "Nivel"])[["T_nivel", "Presupuesto_bits", "Correcto"]].median())
+    print(df_profundidad[df_profundidad["Correcto"] == 1].groupby(["Libreria", "Sec_Level", "Circuito"])["Nivel"].max())
+
+# Modo de rendimiento (test_*_rendimiento, include/rendimiento.h): media de las repeticiones
+if os.path.exists("rendimiento.csv"):
+    df_rendimiento = pd.read_csv("rendimiento.csv")
+    print("Rendimiento con peticiones en paralelo")
+    print(df_rendimiento.groupby(["Libreria", "Sec_Level", "Hilos"]).mean().drop(columns="Iteracion"))
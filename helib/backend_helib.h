@@ -0,0 +1,136 @@
+// Adaptador de BGV en HElib para el benchmark común de include/backend.h.
+// Parámetros de test_helib_criptosistema.cpp: p = 65537, m = 65536 y los bits
+// del módulo para cada nivel de seguridad. Los mensajes van en las ranuras
+// (Ptxt), así que el producto en claro es por ranuras. La rotación es la de
+// EncryptedArray, a la derecha sobre todas las ranuras como un vector (con m
+// potencia de dos puede necesitar varios automorfismos). La profundidad que se alcanza la fijan los bits del módulo,
+// así que el constructor la ignora.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+#include <helib/helib.h>
+
+class backend_helib {
+public:
+    using texto_plano = helib::Ptxt<helib::BGV>;
+    using cifrado = helib::Ctxt;
+    using producto = helib::Ctxt;
+    static constexpr bool rotacion = true;
+
+    static char const* nombre() { return "helib"; }
+
+    explicit backend_helib(int nivel_seguridad, int /*profundidad*/ = 2)
+        : context_(helib::ContextBuilder<helib::BGV>()
+                       .m(32768*2)
+                       .p(p_)
+                       .r(1)
+                       .bits(bits(nivel_seguridad))
+                       .c(1)
+                       .build()) {}
+
+    // GenSecKey también genera la matriz de relinealización
+    void generar_claves() {
+        secret_key_.reset(new helib::SecKey(context_));
+        secret_key_->GenSecKey();
+    }
+
+    void generar_claves_rotacion() {
+        helib::addSome1DMatrices(*secret_key_);
+    }
+
+    size_t ranuras() const { return context_.getEA().size(); }
+    size_t grado() const { return context_.getPhiM(); }
+    int64_t modulo() const { return p_; }
+
+    texto_plano codificar(std::vector<int64_t> const& valores) const {
+        return texto_plano(context_, std::vector<long>(valores.begin(), valores.end()));
+    }
+
+    cifrado cifrar(texto_plano&& mensaje) const {
+        helib::PubKey const& public_key = *secret_key_;
+        helib::Ctxt resultado(public_key);
+        public_key.Encrypt(resultado, mensaje);
+        return resultado;
+    }
+
+    cifrado sumar(cifrado const& a, cifrado const& b) const {
+        helib::Ctxt resultado = a;
+        resultado += b;
+        return resultado;
+    }
+
+    producto multiplicar(cifrado const& a, cifrado const& b) const {
+        helib::Ctxt resultado = a;
+        resultado.multLowLvl(b);
+        return resultado;
+    }
+
+    cifrado relinealizar(producto p) const {
+        p.reLinearize();
+        return p;
+    }
+
+    cifrado rotar(cifrado const& c, int pasos) const {
+        helib::Ctxt resultado = c;
+        context_.getEA().rotate(resultado, pasos);
+        return resultado;
+    }
+
+    std::vector<int64_t> descifrar(cifrado const& c) const {
+        texto_plano resultado(context_);
+        secret_key_->Decrypt(resultado, c);
+        std::vector<int64_t> valores(resultado.size());
+        for (size_t i = 0; i < valores.size(); i++) {
+            valores[i] = static_cast<long>(resultado[i]);
+        }
+        return valores;
+    }
+
+    void serializar(cifrado const& c, std::ostream& salida) const {
+        c.writeTo(salida);
+    }
+
+    // Cota del ruido que lleva HElib (no el ruido real): log2(q / ruido)
+    double presupuesto_ruido(cifrado const& c, std::vector<int64_t> const&) const {
+        return c.capacity();
+    }
+
+    std::vector<int64_t> producto_claro(std::vector<int64_t> const& a, std::vector<int64_t> const& b) const {
+        std::vector<int64_t> c(a.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            c[i] = a[i] * b[i] % p_;
+        }
+        return c;
+    }
+
+    std::vector<int64_t> rotacion_claro(std::vector<int64_t> const& valores, int pasos) const {
+        long const n = static_cast<long>(ranuras());
+        std::vector<int64_t> todas(valores);
+        todas.resize(n, 0);
+        std::vector<int64_t> r(n);
+        for (long i = 0; i < n; i++) {
+            r[i] = todas[((i - pasos) % n + n) % n];
+        }
+        return r;
+    }
+
+private:
+    static unsigned long bits(int nivel_seguridad) {
+        switch (nivel_seguridad) {
+            case 128: return 829;
+            case 192: return 573;
+            case 256: return 445;
+            default: throw std::invalid_argument("Nivel de seguridad inválido");
+        }
+    }
+
+    static constexpr unsigned long p_ = 65537; // Módulo del texto plano
+    helib::Context context_;
+    std::unique_ptr<helib::SecKey> secret_key_;
+};
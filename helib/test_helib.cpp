@@ -1,19 +1,21 @@
 #include <helib/helib.h>
 #include <NTL/ZZX.h>
-#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <random>
+#include <string>
 #include <vector>
 #include "tools.h"
+#include "benchmark.h"
 
 #define N_POLINOMIOS 10 // En cada test creamos 10 polinomios
-#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
 
 #define CSV_FILE "statistics.csv"
+#define CSV_RESUMEN "statistics_resumen.csv"
 #define LIBRERIA "helib" // Utilizada para saber a qué librería pertenece
 
 template<size_t modulus> 
-int run_poly(int n_test) {
+int run_poly() {
     // Parámetros similares a NFLlib
     long degree = 256;        // grado polinomio
     long p = 65537;           // Móulo plaintext estándar
@@ -31,97 +33,90 @@ int run_poly(int n_test) {
                        .build();
 
     // Para los tiempos
-    std::chrono::high_resolution_clock::time_point start, finish;
-
-    // Crear polinomios NTL
-    std::vector<NTL::ZZX> polinomio_a, polinomio_b;
-    polinomio_a.reserve(N_POLINOMIOS);
-    polinomio_b.reserve(N_POLINOMIOS);
-    // Creo distribución uniforme para generar los polinomios
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<long> dist(0, 1000);
-
-    NTL::ZZX polinomio_a_t, polinomio_b_t; // Creo polinomios temporales que voy metiendo en el vector
-    polinomio_a_t.SetLength(degree+1);
-    polinomio_b_t.SetLength(degree+1);
-
-    // Test 1: Tiempo de creación de polinomios
-    start = std::chrono::high_resolution_clock::now();
-    for (int k=0; k< N_POLINOMIOS; ++k){
-        for (int i=0; i<=degree; i++){
-            polinomio_a_t[i] = dist(gen);
-            polinomio_b_t[i] = dist(gen);
+    bench::harness h({"T_polinomio", "T_NTT", "T_suma", "T_multiplicacion", "T_INTT"});
+
+    while (h.siguiente()) {
+        // Crear polinomios NTL
+        std::vector<NTL::ZZX> polinomio_a, polinomio_b;
+        polinomio_a.reserve(N_POLINOMIOS);
+        polinomio_b.reserve(N_POLINOMIOS);
+        // Creo distribución uniforme para generar los polinomios
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<long> dist(0, 1000);
+
+        NTL::ZZX polinomio_a_t, polinomio_b_t; // Creo polinomios temporales que voy metiendo en el vector
+        polinomio_a_t.SetLength(degree+1);
+        polinomio_b_t.SetLength(degree+1);
+
+        // Test 1: Tiempo de creación de polinomios
+        h.start("T_polinomio");
+        for (int k=0; k< N_POLINOMIOS; ++k){
+            for (int i=0; i<=degree; i++){
+                polinomio_a_t[i] = dist(gen);
+                polinomio_b_t[i] = dist(gen);
+            }
+            polinomio_a.push_back(polinomio_a_t);
+            polinomio_b.push_back(polinomio_b_t);
         }
-        polinomio_a.push_back(polinomio_a_t);
-        polinomio_b.push_back(polinomio_b_t);
-    }
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_polinomio = get_time_us(start, finish, N_POLINOMIOS);
+        h.stop("T_polinomio", N_POLINOMIOS);
     
-    // IndexSet para el polinomio
-    helib::IndexSet allPrimes = context.getCtxtPrimes();
-    // Convertir a DoubleCRT (aplica NTT/convolución)
-    std::vector<helib::DoubleCRT> dcrt_a, dcrt_b;
-    dcrt_a.reserve(N_POLINOMIOS);
-    dcrt_b.reserve(N_POLINOMIOS);
-
-    //Test 2: Transformada diercta NTT (En este caso es NTT y RNS)
-    start = std::chrono::steady_clock::now();
-    for (int i = 0; i< N_POLINOMIOS; i++){
-        helib::DoubleCRT dcrt_a_t(polinomio_a[i], context, allPrimes);
-        helib::DoubleCRT dcrt_b_t(polinomio_b[i], context, allPrimes);
-
-        dcrt_a.push_back(dcrt_a_t);
-        dcrt_b.push_back(dcrt_b_t);
-    }
-    finish = std::chrono::steady_clock::now();
-    double tiempo_ntt = get_time_us(start, finish, 2*N_POLINOMIOS);
-
-    // Test 3: Suma NTT
-    std::vector<helib::DoubleCRT> dcrt_c = dcrt_a;
-    start = std::chrono::steady_clock::now();
-    for (int i=0; i< N_POLINOMIOS; i++){
-        dcrt_c[i] += dcrt_b[i];
-    }
-    finish = std::chrono::steady_clock::now();
-    double tiempo_suma = get_time_us(start, finish, N_POLINOMIOS);
-
-    // Test 4: Multiplicación NTT
-    dcrt_c = dcrt_a;
-    start = std::chrono::steady_clock::now();
-    for (int i=0; i< N_POLINOMIOS; i++){
-        dcrt_c[i] *= dcrt_b[i];
-    }
-    finish = std::chrono::steady_clock::now();
-    double tiempo_multiplicacion = get_time_us(start, finish, N_POLINOMIOS);
+        // IndexSet para el polinomio
+        helib::IndexSet allPrimes = context.getCtxtPrimes();
+        // Convertir a DoubleCRT (aplica NTT/convolución)
+        std::vector<helib::DoubleCRT> dcrt_a, dcrt_b;
+        dcrt_a.reserve(N_POLINOMIOS);
+        dcrt_b.reserve(N_POLINOMIOS);
+
+        //Test 2: Transformada diercta NTT (En este caso es NTT y RNS)
+        h.start("T_NTT");
+        for (int i = 0; i< N_POLINOMIOS; i++){
+            helib::DoubleCRT dcrt_a_t(polinomio_a[i], context, allPrimes);
+            helib::DoubleCRT dcrt_b_t(polinomio_b[i], context, allPrimes);
+
+            dcrt_a.push_back(dcrt_a_t);
+            dcrt_b.push_back(dcrt_b_t);
+        }
+        h.stop("T_NTT", 2*N_POLINOMIOS);
 
-    // Test 5: Transformada inversa NTT
-    start = std::chrono::steady_clock::now();
-    for (int i=0; i< N_POLINOMIOS; i++){
-        dcrt_a[i].toPoly(polinomio_a_t);
-        dcrt_b[i].toPoly(polinomio_b_t);
+        // Test 3: Suma NTT
+        std::vector<helib::DoubleCRT> dcrt_c = dcrt_a;
+        h.start("T_suma");
+        for (int i=0; i< N_POLINOMIOS; i++){
+            dcrt_c[i] += dcrt_b[i];
+        }
+        h.stop("T_suma", N_POLINOMIOS);
 
-        polinomio_a[i] = polinomio_a_t;
-        polinomio_b[i] = polinomio_b_t;
+        // Test 4: Multiplicación NTT
+        dcrt_c = dcrt_a;
+        h.start("T_multiplicacion");
+        for (int i=0; i< N_POLINOMIOS; i++){
+            dcrt_c[i] *= dcrt_b[i];
+        }
+        h.stop("T_multiplicacion", N_POLINOMIOS);
+
+        // Test 5: Transformada inversa NTT
+        h.start("T_INTT");
+        for (int i=0; i< N_POLINOMIOS; i++){
+            dcrt_a[i].toPoly(polinomio_a_t);
+            dcrt_b[i].toPoly(polinomio_b_t);
+
+            polinomio_a[i] = polinomio_a_t;
+            polinomio_b[i] = polinomio_b_t;
+        }
+        h.stop("T_INTT", 2*N_POLINOMIOS);
     }
-    finish = std::chrono::steady_clock::now();
-    double tiempo_intt = get_time_us(start, finish, 2*N_POLINOMIOS);
 
     // Fin: Escribe resultados en csv
-    std::ofstream datos_csv;
-    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
-    datos_csv << LIBRERIA << "," << n_test << "," << modulus << "," << tiempo_polinomio << "," << tiempo_ntt << "," << tiempo_suma << "," << tiempo_multiplicacion << "," << tiempo_intt << "\n";
-    datos_csv.close();
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(modulus));
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(modulus));
 
     return 0;
 }
 
 int main(){
     // Ejecutamos los test para los tres tamaños
-    for (int i=0; i< REPETICIONES; i++){
-        run_poly<14>(i);
-        run_poly<30>(i);
-        run_poly<62>(i);
-    }
+    run_poly<14>();
+    run_poly<30>();
+    run_poly<62>();
 }
@@ -0,0 +1,146 @@
+// Arranque en frío y en caliente de BGV en HElib con la caché de contextos y
+// claves de include/cache_claves.h:
+//   T_frio      sin caché: se construye el contexto (m = 65536) y se generan
+//               las claves, y se guardan en la caché
+//   T_caliente  con caché: se leen el contexto y la clave secreta con la
+//               pública y las matrices de key switching
+// Con las claves cargadas se comprueba un producto. Al terminar la caché queda
+// completa para las siguientes ejecuciones.
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <helib/helib.h>
+#include "tools.h"
+#include "benchmark.h"
+#include "cache_claves.h"
+
+#ifndef VERSION_HELIB
+#define VERSION_HELIB "desconocida" // La pone el CMakeLists.txt
+#endif
+
+#define N_COEF 10 // Coeficiente de los polinomios
+#define CSV_FILE "he_cache.csv"
+#define CSV_RESUMEN "he_cache_resumen.csv"
+#define LIBRERIA "helib" // Utilizada para saber a qué librería pertenece
+
+struct conjunto_claves {
+    std::unique_ptr<helib::Context> context;
+    std::unique_ptr<helib::SecKey> secret_key;
+};
+
+int run_bgv(int security_level)
+{
+    // Parámetros (los de test_helib_criptosistema.cpp)
+    unsigned long p = 65537;
+    unsigned long m = 32768*2; // n de homomorphicstandard
+    unsigned long r = 1; // Por defecto
+    unsigned long bits;
+    switch (security_level){
+        case 128: bits = 829; break;
+        case 192: bits = 573; break;
+        case 256: bits = 445; break;
+        default:
+            std::cerr << "Nivel de seguridad inválido.\n";
+            return 1;
+      }
+    unsigned long c_keyswtich = 1; // nummero de columnas de keyswitch lo dejo por defecto
+    std::string entrada = cache::entrada(LIBRERIA, std::string("helib ") + VERSION_HELIB + " BGV m=" + std::to_string(m) + " p=" +
+                                                   std::to_string(p) + " r=" + std::to_string(r) + " bits=" + std::to_string(bits) +
+                                                   " c=" + std::to_string(c_keyswtich));
+
+    std::function<conjunto_claves()> generar = [&]() {
+        conjunto_claves c;
+        c.context.reset(helib::ContextBuilder<helib::BGV>()
+                            .m(m)
+                            .p(p)
+                            .r(r)
+                            .bits(bits)
+                            .c(c_keyswtich)
+                            .buildPtr());
+        c.secret_key.reset(new helib::SecKey(*c.context));
+        c.secret_key->GenSecKey();
+        return c;
+    };
+    std::function<void(conjunto_claves const&)> guardar = [&](conjunto_claves const& c) {
+        std::ofstream contexto(entrada + "contexto.bin", std::ios::binary);
+        c.context->writeTo(contexto);
+        std::ofstream claves(entrada + "claves.bin", std::ios::binary);
+        c.secret_key->writeTo(claves); // Con la parte pública
+        // Se cierran antes de comprobar: un error al vaciar el búfer solo se ve aquí
+        contexto.close();
+        claves.close();
+        if (!contexto || !claves) {
+            throw std::runtime_error("no se puede escribir la caché en " + entrada);
+        }
+    };
+    std::function<conjunto_claves()> cargar = [&]() {
+        conjunto_claves c;
+        std::ifstream contexto(entrada + "contexto.bin", std::ios::binary);
+        std::ifstream claves(entrada + "claves.bin", std::ios::binary);
+        if (!contexto || !claves) {
+            throw std::runtime_error("no se puede leer la caché de " + entrada);
+        }
+        c.context.reset(helib::Context::readPtrFrom(contexto));
+        c.secret_key.reset(new helib::SecKey(helib::SecKey::readFrom(claves, *c.context)));
+        return c;
+    };
+
+    std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    bench::harness h({"T_frio", "T_caliente"});
+    while (h.siguiente()) {
+        bool cargado = false;
+        cache::borrar(entrada);
+        h.start("T_frio");
+        conjunto_claves frio = cache::obtener(entrada, generar, guardar, cargar, &cargado);
+        h.stop("T_frio");
+
+        h.start("T_caliente");
+        conjunto_claves caliente = cache::obtener(entrada, generar, guardar, cargar, &cargado);
+        h.stop("T_caliente");
+        if (!cargado) {
+            std::cout << "Error: la caché de " << entrada << " no se ha cargado\n";
+            return 1;
+        }
+
+        // Las claves cargadas tienen que servir para multiplicar y descifrar
+        helib::Context const& context = *caliente.context;
+        helib::PubKey const& public_key = *caliente.secret_key;
+        helib::Ctxt ciphertext_a(public_key), ciphertext_b(public_key);
+        public_key.Encrypt(ciphertext_a, helib::Ptxt<helib::BGV>(context, a));
+        public_key.Encrypt(ciphertext_b, helib::Ptxt<helib::BGV>(context, b));
+        ciphertext_a *= ciphertext_b;
+        helib::Ptxt<helib::BGV> plaintext_mul(context);
+        caliente.secret_key->Decrypt(plaintext_mul, ciphertext_a);
+        for (int i = 0; i < N_COEF; i++) {
+            if (static_cast<long>(plaintext_mul[i]) != a[i] * b[i] % static_cast<long>(p)) {
+                std::cout << "Error: las claves de la caché no descifran bien\n";
+                return 1;
+            }
+        }
+        if (h.primera()) {
+            std::cout << "Caché de " << security_level << " en " << entrada << std::endl;
+        }
+    }
+
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(security_level));
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(security_level));
+    return 0;
+}
+
+int main(){
+    try {
+        int error = run_bgv(128);
+        error |= run_bgv(192);
+        error |= run_bgv(256);
+        return error;
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
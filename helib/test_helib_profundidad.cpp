@@ -0,0 +1,27 @@
+// Coste por nivel de profundidad multiplicativa de BGV en HElib
+// (include/profundidad.h): cadenas de productos, árboles equilibrados y sumas
+// de productos. El presupuesto es la capacidad que estima HElib.
+
+#include <exception>
+#include <iostream>
+#include "tools.h"
+#include "profundidad.h"
+#include "backend_helib.h"
+
+#define PROFUNDIDAD_MAXIMA 32 // Niveles de la cadena y de la suma de productos
+#define PROFUNDIDAD_ARBOL 5 // Niveles del árbol (2^5 hojas)
+#define TERMINOS 4 // Productos que se suman en cada nivel
+#define REPETICIONES 3 // Vamos a hacer 3 repeticiones por circuito
+#define CSV_FILE "profundidad.csv"
+
+int main() {
+    try {
+        int error = bench::ejecutar_profundidad<backend_helib>(CSV_FILE, 128, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+        error |= bench::ejecutar_profundidad<backend_helib>(CSV_FILE, 192, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+        error |= bench::ejecutar_profundidad<backend_helib>(CSV_FILE, 256, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+        return error;
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,96 @@
+// Rendimiento de BGV en HElib con peticiones independientes en paralelo
+// (rendimiento.h): los hilos comparten el contexto y las claves y cada uno
+// atiende un flujo de peticiones. Una petición cifra dos vectores, los suma y
+// los multiplica y descifra la suma y el producto. NTL debe estar compilada con
+// NTL_THREADS (lo está por defecto); su reserva de hilos se deja en uno para
+// que el paralelismo sea solo el de las peticiones.
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <helib/helib.h>
+#include <NTL/BasicThreadPool.h>
+#include "tools.h"
+#include "rendimiento.h"
+
+#define N_COEF 10 // Coeficiente de los polinomios
+#define PETICIONES 4 // Peticiones por hilo en cada medida
+#define REPETICIONES 5 // Medidas para cada número de hilos
+#define CSV_FILE "rendimiento.csv"
+#define LIBRERIA "helib" // Utilizada para saber a qué librería pertenece
+
+int run_bgv(int security_level)
+{
+    // Parámetros (los de test_helib_criptosistema.cpp)
+    unsigned long p = 65537;
+    unsigned long m = 32768*2; // n de homomorphicstandard
+    unsigned long r = 1; // Por defecto
+    unsigned long bits;
+    switch (security_level){
+        case 128: bits = 829; break;
+        case 192: bits = 573; break;
+        case 256: bits = 445; break;
+        default:
+            std::cerr << "Nivel de seguridad inválido.\n";
+            return 1;
+      }
+    unsigned long c_keyswtich = 1; // nummero de columnas de keyswitch lo dejo por defecto
+    NTL::SetNumThreads(1);
+    helib::Context context = helib::ContextBuilder<helib::BGV>()
+                                 .m(m)
+                                 .p(p)
+                                 .r(r)
+                                 .bits(bits)
+                                 .c(c_keyswtich)
+                                 .build();
+    helib::SecKey secret_key(context);
+    secret_key.GenSecKey();
+    const helib::PubKey& public_key = secret_key;
+
+    std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    helib::Ptxt<helib::BGV> plaintext_a(context, a);
+    helib::Ptxt<helib::BGV> plaintext_b(context, b);
+    std::vector<long> esperado_suma(N_COEF), esperado(N_COEF);
+    for (int i = 0; i < N_COEF; i++) {
+        esperado_suma[i] = (a[i] + b[i]) % p;
+        esperado[i] = a[i] * b[i] % p;
+    }
+
+    try {
+        bench::barrido_rendimiento(CSV_FILE, LIBRERIA, std::to_string(security_level), REPETICIONES, PETICIONES, [&](size_t) {
+            return [&]() {
+                helib::Ctxt ciphertext_a(public_key), ciphertext_b(public_key);
+                public_key.Encrypt(ciphertext_a, plaintext_a);
+                public_key.Encrypt(ciphertext_b, plaintext_b);
+                helib::Ctxt suma = ciphertext_a;
+                suma += ciphertext_b;
+                helib::Ctxt producto = ciphertext_a;
+                producto *= ciphertext_b;
+                helib::Ptxt<helib::BGV> plaintext_suma(context), plaintext_producto(context);
+                secret_key.Decrypt(plaintext_suma, suma);
+                secret_key.Decrypt(plaintext_producto, producto);
+                for (int i = 0; i < N_COEF; i++) {
+                    if (static_cast<long>(plaintext_suma[i]) != esperado_suma[i]) {
+                        throw std::runtime_error("la suma no descifra bien");
+                    }
+                    if (static_cast<long>(plaintext_producto[i]) != esperado[i]) {
+                        throw std::runtime_error("el producto no descifra bien");
+                    }
+                }
+            };
+        });
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(){
+    int error = run_bgv(128);
+    error |= run_bgv(192);
+    error |= run_bgv(256);
+    return error;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+// Benchmark común de los esquemas homomórficos: la misma carga y las mismas
+// fronteras de medida para cualquier librería, a través de un adaptador
+// (backend) que se elige en compilación. El driver es una plantilla sobre el
+// adaptador, así que las llamadas se resuelven y se pueden expandir en línea:
+// no hay funciones virtuales entre la medida y el código de la librería.
+//
+// Un adaptador B tiene:
+//   using texto_plano, cifrado, producto;  // producto: multiplicación sin relinealizar
+//   static constexpr bool rotacion;        // si sabe rotar las ranuras
+//   static char const* nombre();
+//   explicit B(int nivel_seguridad, int profundidad = 2); // parámetros y contexto
+//   void generar_claves();                 // secreta, pública y de relinealización
+//   void generar_claves_rotacion();        // claves para rotar una posición
+//   size_t ranuras() const;                // elementos del texto plano
+//   size_t grado() const;                  // dimensión del anillo
+//   int64_t modulo() const;                // módulo del texto plano
+//   texto_plano codificar(std::vector<int64_t> const&) const;
+//   cifrado cifrar(texto_plano&&) const;   // puede consumir el texto plano
+//   cifrado sumar(cifrado const&, cifrado const&) const;
+//   producto multiplicar(cifrado const&, cifrado const&) const;
+//   cifrado relinealizar(producto) const;
+//   cifrado rotar(cifrado const&, int pasos) const;
+//   std::vector<int64_t> descifrar(cifrado const&) const; // descifra y decodifica, en [0, modulo)
+//   void serializar(cifrado const&, std::ostream&) const;
+//   // Bits de ruido que quedan antes de que falle el descifrado (NaN si la
+//   // librería no lo da), conocido el mensaje esperado
+//   double presupuesto_ruido(cifrado const&, std::vector<int64_t> const& esperado) const;
+//   // Producto en claro con la codificación del adaptador (por ranuras, o de
+//   // polinomios si codifica en los coeficientes)
+//   std::vector<int64_t> producto_claro(std::vector<int64_t> const&, std::vector<int64_t> const&) const;
+//   // Rotación en claro como la de rotar() (todas las ranuras; lanza si no hay rotaciones)
+//   std::vector<int64_t> rotacion_claro(std::vector<int64_t> const&, int pasos) const;
+//
+// Adaptadores: nfllib/backend_nfllib.hpp, openfhe/backend_openfhe.h y
+// helib/backend_helib.h. Los circuitos por profundidad están en profundidad.h.
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "benchmark.h"
+
+#define CSV_BACKEND "backend.csv"
+#define CSV_BACKEND_RESUMEN "backend_resumen.csv"
+#define CSV_BACKEND_TAMANOS "tamanos.csv"
+
+namespace bench {
+
+// Una iteración crea el contexto y las claves, codifica y cifra a y b, calcula
+// a + b, a * b (multiplicación y relinealización por separado) y la rotación
+// de a, descifra la suma y el producto y serializa un criptograma. La rotación
+// también se descifra y se comprueba, fuera de la medida. a y b son
+// 10 valores, o llenan todas las ranuras con BENCH_LLENAR. Devuelve 1 si algún
+// resultado no descifra bien.
+template <class B>
+int ejecutar_backend(int nivel_seguridad) {
+    std::string const grupo = std::to_string(nivel_seguridad);
+    harness h({"T_context", "T_keygen", "T_claves_rotacion", "T_codificar", "T_cifrado", "T_suma",
+               "T_multiplicacion", "T_relinealizacion", "T_rotacion", "T_descifrado", "T_serializacion"});
+    while (h.siguiente()) {
+        h.start("T_context");
+        B backend(nivel_seguridad);
+        h.stop("T_context");
+
+        h.start("T_keygen");
+        backend.generar_claves();
+        h.stop("T_keygen");
+        if (B::rotacion) {
+            h.start("T_claves_rotacion");
+            backend.generar_claves_rotacion();
+            h.stop("T_claves_rotacion");
+        }
+
+        std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+        std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+        if (h.llenar()) {
+            a = datos_aleatorios(backend.ranuras(), backend.modulo(), 0);
+            b = datos_aleatorios(backend.ranuras(), backend.modulo(), 1);
+        }
+        h.carga(a.size(), backend.ranuras(), backend.grado(),
+                {"T_codificar", "T_cifrado", "T_suma", "T_multiplicacion", "T_relinealizacion", "T_rotacion",
+                 "T_descifrado", "T_serializacion"});
+
+        h.start("T_codificar");
+        typename B::texto_plano plano_a = backend.codificar(a);
+        typename B::texto_plano plano_b = backend.codificar(b);
+        h.stop("T_codificar", 2);
+
+        h.start("T_cifrado");
+        typename B::cifrado cifrado_a = backend.cifrar(std::move(plano_a));
+        typename B::cifrado cifrado_b = backend.cifrar(std::move(plano_b));
+        h.stop("T_cifrado", 2);
+
+        h.start("T_suma");
+        typename B::cifrado suma = backend.sumar(cifrado_a, cifrado_b);
+        h.stop("T_suma");
+
+        h.start("T_multiplicacion");
+        typename B::producto producto = backend.multiplicar(cifrado_a, cifrado_b);
+        h.stop("T_multiplicacion");
+
+        h.start("T_relinealizacion");
+        typename B::cifrado relinealizado = backend.relinealizar(std::move(producto));
+        h.stop("T_relinealizacion");
+
+        std::vector<int64_t> resultado_rotacion;
+        if (B::rotacion) {
+            h.start("T_rotacion");
+            typename B::cifrado rotado = backend.rotar(cifrado_a, 1);
+            h.stop("T_rotacion");
+            resultado_rotacion = backend.descifrar(rotado);
+        }
+
+        h.start("T_descifrado");
+        std::vector<int64_t> resultado_suma = backend.descifrar(suma);
+        std::vector<int64_t> resultado_producto = backend.descifrar(relinealizado);
+        h.stop("T_descifrado", 2);
+
+        memoria::contador_buf buf;
+        std::ostream salida(&buf);
+        h.start("T_serializacion");
+        backend.serializar(cifrado_a, salida);
+        h.stop("T_serializacion");
+
+        // Comprobación con las operaciones en claro
+        std::vector<int64_t> esperado_producto = backend.producto_claro(a, b);
+        for (size_t i = 0; i < a.size(); i++) {
+            if (resultado_suma[i] != (a[i] + b[i]) % backend.modulo() || resultado_producto[i] != esperado_producto[i]) {
+                std::cout << "Error: " << B::nombre() << " " << grupo << " no descifra bien la posición " << i << std::endl;
+                return 1;
+            }
+        }
+        if (B::rotacion) {
+            std::vector<int64_t> esperado_rotacion = backend.rotacion_claro(a, 1);
+            for (size_t i = 0; i < a.size(); i++) {
+                if (resultado_rotacion[i] != esperado_rotacion[i]) {
+                    std::cout << "Error: " << B::nombre() << " " << grupo << " no rota bien la posición " << i << std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        if (h.primera()) {
+            memoria::escribir_tamano(CSV_BACKEND_TAMANOS, B::nombre(), grupo, "criptograma_backend", buf.bytes());
+            std::cout << B::nombre() << " " << grupo << ": " << backend.ranuras() << " ranuras, grado " << backend.grado()
+                      << (B::rotacion ? "" : ", sin rotaciones") << std::endl;
+            std::cout << "a * b: [";
+            for (size_t i = 0; i < 10; i++) {
+                std::cout << resultado_producto[i] << (i == 9 ? ", ...]\n" : ", ");
+            }
+        }
+    }
+
+    h.escribir_iteraciones(CSV_BACKEND, B::nombre(), grupo);
+    h.escribir_resumen(CSV_BACKEND_RESUMEN, B::nombre(), grupo);
+    return 0;
+}
+
+} // namespace bench
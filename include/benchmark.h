@@ -0,0 +1,571 @@
+#pragma once
+
+// Arnés de medida común a los benchmarks de las tres librerías.
+// Un benchmark declara sus fases (las columnas de tiempo del CSV) y repite una
+// iteración completa mientras siguiente() lo permita; dentro de la iteración
+// cada fase se mide con start()/stop():
+//
+//   bench::harness h({"T_keygen", "T_cifrado", "T_suma"});
+//   while (h.siguiente()) {
+//       h.start("T_keygen");
+//       ...
+//       h.stop("T_keygen");
+//       h.start("T_cifrado");
+//       ...
+//       h.stop("T_cifrado", 3); // tres cifrados: se guarda el tiempo de uno
+//   }
+//   h.escribir_iteraciones("he_schemes.csv", "nfllib", "128");
+//   h.escribir_resumen("he_schemes_resumen.csv", "nfllib", "128");
+//
+// Las primeras iteraciones son de calentamiento y no se guardan (cachés,
+// tablas que se construyen al primer uso, frecuencia de la CPU). Después se
+// itera hasta tener un mínimo de iteraciones y un mínimo de tiempo medido, con
+// un máximo de iteraciones. De cada fase se calcula la media, la desviación,
+// la mediana con su intervalo de confianza del 95% (por estadísticos de orden,
+// sin suponer normalidad), los percentiles 90 y 99 y los valores atípicos
+// (fuera de 1.5 veces el rango intercuartílico).
+// Los valores por defecto se pueden cambiar sin recompilar con las variables
+// de entorno BENCH_CALENTAMIENTO, BENCH_MIN_ITER, BENCH_MAX_ITER y
+// BENCH_TIEMPO_MIN_MS.
+// Las fases se miden con cycle_timer (tools.h): ciclos del TSC descontando el
+// coste de la medida, o steady_clock si no hay TSC invariante. El resumen
+// incluye también la mediana en ciclos.
+// Con BENCH_PERF=1 se abren además contadores hardware (perf_counters.h)
+// alrededor de cada fase: ciclos, instrucciones, fallos de L1D y de LLC,
+// fallos de predicción de salto y fallos de DTLB. El resumen añade la mediana
+// de cada uno por operación; si el kernel no da los contadores (contenedor,
+// perf_event_paranoid, máquina virtual) se avisa y esas columnas quedan vacías.
+// Con BENCH_MEMORIA=1 se mide también la memoria de cada fase (memoria.h):
+// reservas y bytes reservados por operación, pico del heap sobre lo que ya
+// estaba reservado al empezar la fase y pico de RSS. Como memoria.h interpone
+// malloc, este fichero solo se incluye en un fichero de cada programa. Si las
+// fases se anidan, la interior reinicia los picos, así que al empezar guarda
+// en las fases abiertas el pico que llevaban y estas se quedan con el máximo.
+// El trabajo de start() y stop() de una fase anidada (leer /proc, los
+// contadores, guardar las muestras) se descuenta del tiempo, las reservas y
+// los contadores hardware de las fases que la contienen.
+// Con carga() el benchmark dice cuántos elementos útiles del texto plano
+// procesa cada operación, cuántas ranuras tiene y la dimensión del anillo, y
+// qué fases trabajan sobre los datos; el resumen añade el coste por elemento
+// útil de esas fases (no de las de contexto o claves, que no dependen de los
+// datos), para comparar librerías que empaquetan cantidades muy distintas de
+// datos. Con BENCH_LLENAR=1 los
+// benchmarks llenan todas las ranuras con datos (datos_aleatorios()).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tools.h"
+#include "perf_counters.h"
+#include "memoria.h"
+
+namespace bench {
+
+struct config {
+    size_t calentamiento;    // Iteraciones iniciales que no se guardan
+    size_t min_iteraciones;  // Iteraciones guardadas como mínimo
+    size_t max_iteraciones;  // y como máximo
+    double tiempo_minimo_us; // Tiempo medido mínimo (suma de las iteraciones guardadas)
+    bool contadores;         // Contadores hardware por fase
+    bool memoria;            // Reservas y picos de memoria por fase
+    bool llenar;             // Llenar todas las ranuras del texto plano
+
+    config(size_t calentamiento = 2, size_t min_iteraciones = 10, size_t max_iteraciones = 1000,
+           double tiempo_minimo_us = 1e6, bool contadores = false, bool memoria = false, bool llenar = false)
+        : calentamiento(calentamiento), min_iteraciones(min_iteraciones), max_iteraciones(max_iteraciones),
+          tiempo_minimo_us(tiempo_minimo_us), contadores(contadores), memoria(memoria), llenar(llenar) {}
+
+    // La configuración c con lo que se haya cambiado en el entorno
+    static config entorno(config c = config()) {
+        leer("BENCH_CALENTAMIENTO", c.calentamiento);
+        leer("BENCH_MIN_ITER", c.min_iteraciones);
+        leer("BENCH_MAX_ITER", c.max_iteraciones);
+        size_t ms;
+        if (leer("BENCH_TIEMPO_MIN_MS", ms)) {
+            c.tiempo_minimo_us = 1e3 * ms;
+        }
+        size_t perf;
+        if (leer("BENCH_PERF", perf)) {
+            c.contadores = perf != 0;
+        }
+        size_t memoria;
+        if (leer("BENCH_MEMORIA", memoria)) {
+            c.memoria = memoria != 0;
+        }
+        size_t llenar;
+        if (leer("BENCH_LLENAR", llenar)) {
+            c.llenar = llenar != 0;
+        }
+        c.max_iteraciones = std::max(c.max_iteraciones, c.min_iteraciones);
+        return c;
+    }
+
+private:
+    static bool leer(char const* variable, size_t& valor) {
+        char const* texto = std::getenv(variable);
+        if (texto == nullptr || *texto == '\0') {
+            return false;
+        }
+        valor = std::strtoul(texto, nullptr, 10);
+        return true;
+    }
+};
+
+struct estadisticos {
+    size_t n = 0;
+    double media = 0, desviacion = 0, minimo = 0, maximo = 0;
+    double mediana = 0, ic_inf = 0, ic_sup = 0; // Mediana e intervalo del 95%
+    double p90 = 0, p99 = 0;
+    size_t atipicos = 0;
+};
+
+// Percentil q (0..1) de unas muestras ordenadas, interpolando entre las dos
+// más cercanas (como numpy.percentile)
+inline double percentil(std::vector<double> const& ordenadas, double q) {
+    if (ordenadas.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double posicion = q * (ordenadas.size() - 1);
+    size_t i = static_cast<size_t>(posicion);
+    if (i + 1 >= ordenadas.size()) {
+        return ordenadas.back();
+    }
+    return ordenadas[i] + (posicion - i) * (ordenadas[i + 1] - ordenadas[i]);
+}
+
+inline estadisticos resumir(std::vector<double> muestras) {
+    estadisticos e;
+    e.n = muestras.size();
+    if (e.n == 0) {
+        return e;
+    }
+    std::sort(muestras.begin(), muestras.end());
+    double suma = 0;
+    for (double m : muestras) {
+        suma += m;
+    }
+    e.media = suma / e.n;
+    double cuadrados = 0;
+    for (double m : muestras) {
+        cuadrados += (m - e.media) * (m - e.media);
+    }
+    e.desviacion = e.n > 1 ? std::sqrt(cuadrados / (e.n - 1)) : 0;
+    e.minimo = muestras.front();
+    e.maximo = muestras.back();
+    e.mediana = percentil(muestras, 0.5);
+    e.p90 = percentil(muestras, 0.9);
+    e.p99 = percentil(muestras, 0.99);
+
+    // Intervalo de la mediana: muestras j y k (desde 1) con j = n/2 - 1.96*sqrt(n)/2
+    // y k = 1 + n/2 + 1.96*sqrt(n)/2 redondeados, aproximando la binomial por la normal
+    double radio = 1.96 * std::sqrt(static_cast<double>(e.n)) / 2;
+    long j = std::lround(e.n / 2.0 - radio);
+    long k = std::lround(1 + e.n / 2.0 + radio);
+    e.ic_inf = muestras[std::max(1L, j) - 1];
+    e.ic_sup = muestras[std::min(static_cast<long>(e.n), k) - 1];
+
+    double q1 = percentil(muestras, 0.25), q3 = percentil(muestras, 0.75);
+    for (double m : muestras) {
+        if (m < q1 - 1.5 * (q3 - q1) || m > q3 + 1.5 * (q3 - q1)) {
+            e.atipicos++;
+        }
+    }
+    return e;
+}
+
+// n valores en [0, modulo) para llenar las ranuras, siempre los mismos para una semilla
+inline std::vector<int64_t> datos_aleatorios(size_t n, int64_t modulo, uint64_t semilla) {
+    std::mt19937_64 generador(semilla);
+    std::uniform_int_distribution<int64_t> distribucion(0, modulo - 1);
+    std::vector<int64_t> datos(n);
+    for (int64_t& d : datos) {
+        d = distribucion(generador);
+    }
+    return datos;
+}
+
+// Contadores hardware del resumen, en el orden de sus columnas
+inline std::vector<perf_evento> eventos_hw() {
+    return {PERF_CICLOS, PERF_INSTRUCCIONES, PERF_FALLOS_L1D, PERF_FALLOS_LLC, PERF_FALLOS_SALTO, PERF_FALLOS_DTLB};
+}
+
+// Medidas de memoria del resumen, en el orden de sus columnas
+enum medida_memoria { MEM_RESERVAS, MEM_BYTES, MEM_PICO_HEAP, MEM_PICO_RSS_KB, N_MEDIDAS_MEMORIA };
+
+class harness {
+public:
+    using reloj = std::chrono::steady_clock;
+
+    explicit harness(std::initializer_list<std::string> fases, config c = config::entorno())
+        : fases_(fases), config_(c), timers_(fases_.size()), hw_(eventos_hw().size()), memoria_(N_MEDIDAS_MEMORIA),
+          inicio_memoria_(fases_.size()), abierta_(fases_.size(), false), pico_heap_anidado_(fases_.size()),
+          pico_rss_anidado_(fases_.size()), descuento_ns_(fases_.size()), descuento_ciclos_(fases_.size()),
+          descuento_reservas_(fases_.size()), descuento_bytes_(fases_.size()), por_elemento_(fases_.size(), false) {
+        if (config_.contadores) {
+            // Un grupo de contadores por fase, para que las fases se puedan anidar
+            for (size_t f = 0; f < fases_.size(); f++) {
+                contadores_.emplace_back(new perf_counters(eventos_hw()));
+                if (!contadores_.back()->disponible()) {
+                    std::cerr << "bench::harness: contadores hardware no disponibles (perf_event_open)" << std::endl;
+                    contadores_.clear();
+                    break;
+                }
+            }
+        }
+        if (config_.memoria) {
+            if (!memoria::interpuesto()) {
+                std::cerr << "bench::harness: sin contar reservas (malloc no interpuesto), solo pico de RSS" << std::endl;
+            }
+            memoria::activar(true);
+        }
+    }
+
+    ~harness() {
+        if (config_.memoria) {
+            memoria::activar(false);
+        }
+    }
+
+    harness(harness const&) = delete;
+    harness& operator=(harness const&) = delete;
+
+    // Empieza la siguiente iteración; false cuando ya no hay que iterar más
+    bool siguiente() {
+        reloj::time_point ahora = reloj::now();
+        if (llamadas_ > config_.calentamiento) {
+            tiempo_medido_us_ += std::chrono::duration<double, std::micro>(ahora - inicio_iteracion_).count();
+        }
+        size_t guardadas = filas_.size();
+        if (guardadas >= config_.max_iteraciones ||
+            (guardadas >= config_.min_iteraciones && tiempo_medido_us_ >= config_.tiempo_minimo_us)) {
+            return false;
+        }
+        llamadas_++;
+        if (!calentando()) {
+            filas_.push_back(std::vector<double>(fases_.size(), std::numeric_limits<double>::quiet_NaN()));
+            ciclos_.push_back(filas_.back());
+            for (std::vector<std::vector<double>>& evento : hw_) {
+                evento.push_back(filas_.back());
+            }
+            for (std::vector<std::vector<double>>& medida : memoria_) {
+                medida.push_back(filas_.back());
+            }
+        }
+        inicio_iteracion_ = reloj::now();
+        return true;
+    }
+
+    // true si hay que llenar todas las ranuras (BENCH_LLENAR)
+    bool llenar() const { return config_.llenar; }
+
+    // Elementos útiles que procesa cada operación, ranuras del texto plano,
+    // dimensión del anillo y fases cuyo coste se reparte entre los elementos
+    void carga(size_t elementos, size_t ranuras, size_t grado, std::initializer_list<std::string> por_elemento) {
+        elementos_ = elementos;
+        ranuras_ = ranuras;
+        grado_ = grado;
+        for (std::string const& fase : por_elemento) {
+            por_elemento_[indice(fase)] = true;
+        }
+    }
+
+    bool calentando() const { return llamadas_ <= config_.calentamiento; }
+    // true en la primera iteración (de calentamiento si lo hay), para mostrar resultados una vez
+    bool primera() const { return llamadas_ == 1; }
+    // Número de la iteración guardada (columna Iteracion del CSV)
+    size_t iteracion() const { return filas_.empty() ? 0 : filas_.size() - 1; }
+
+    // Las fases se pasan como char const* para no construir un std::string
+    // (que reserva memoria) dentro de la medida
+    void start(char const* fase) {
+        size_t f = indice(fase);
+        contabilidad_inicio();
+        if (config_.memoria) {
+            // Los picos se reinician: las fases abiertas guardan el que llevaban.
+            // Primero el del heap, antes de que leer /proc reserve memoria
+            for (size_t o = 0; o < fases_.size(); o++) {
+                if (abierta_[o]) {
+                    pico_heap_anidado_[o] = std::max(pico_heap_anidado_[o], memoria::pico());
+                }
+            }
+            for (size_t o = 0; o < fases_.size(); o++) {
+                if (abierta_[o]) {
+                    pico_rss_anidado_[o] = std::max(pico_rss_anidado_[o], memoria::pico_rss_kb());
+                }
+            }
+            pico_heap_anidado_[f] = std::numeric_limits<int64_t>::min();
+            pico_rss_anidado_[f] = 0;
+            memoria::reiniciar_rss();
+            inicio_memoria_[f] = memoria::ahora();
+            memoria::reiniciar_pico();
+        }
+        contabilidad_fin(f);
+        abierta_[f] = true;
+        descuento_ns_[f] = descuento_ciclos_[f] = 0;
+        descuento_reservas_[f] = descuento_bytes_[f] = 0;
+        if (!contadores_.empty()) {
+            contadores_[f]->start();
+        }
+        timers_[f].start();
+    }
+
+    // Termina la medida de la fase; se guarda el tiempo de una de las
+    // operaciones. Si una fase se mide varias veces en una iteración, se suma.
+    // El reloj se lee antes de buscar la fase, para que la búsqueda no se mida.
+    void stop(char const* fase, double operaciones = 1) {
+        timer_mark fin_medida = cycle_timer::mark();
+        memoria::instantanea fin = memoria::ahora();
+        size_t f = indice(fase);
+        timer_sample medida = timers_[f].stop(fin_medida);
+        if (!contadores_.empty()) {
+            contadores_[f]->stop();
+        }
+        contabilidad_inicio();
+        abierta_[f] = false;
+        double ns = std::max(0.0, medida.ns - descuento_ns_[f]);
+        double ciclos = std::max(0.0, static_cast<double>(medida.cycles) - descuento_ciclos_[f]);
+        registrar(f, ns / 1e3 / operaciones,
+                  timers_[f].calibration().tsc ? ciclos / operaciones : std::numeric_limits<double>::quiet_NaN());
+        if (!contadores_.empty()) {
+            for (size_t e = 0; e < hw_.size(); e++) {
+                int64_t valor = contadores_[f]->valor(e);
+                anotar(hw_[e], f, valor < 0 ? std::numeric_limits<double>::quiet_NaN() : valor / operaciones);
+            }
+        }
+        if (config_.memoria) {
+            int64_t pico = std::max(memoria::pico(), pico_heap_anidado_[f]);
+            // Las fases abiertas se quedan con el pico del heap hasta aquí; lo
+            // que reserve leer /proc no cuenta porque el pico se reinicia al final
+            for (size_t o = 0; o < fases_.size(); o++) {
+                if (abierta_[o]) {
+                    pico_heap_anidado_[o] = std::max(pico_heap_anidado_[o], memoria::pico());
+                }
+            }
+            long pico_rss = std::max(memoria::pico_rss_kb(), pico_rss_anidado_[f]);
+            memoria::instantanea const& inicio = inicio_memoria_[f];
+            if (memoria::interpuesto()) {
+                anotar(memoria_[MEM_RESERVAS], f, (fin.reservas - inicio.reservas - descuento_reservas_[f]) / operaciones);
+                anotar(memoria_[MEM_BYTES], f, (fin.bytes - inicio.bytes - descuento_bytes_[f]) / operaciones);
+                anotar(memoria_[MEM_PICO_HEAP], f, static_cast<double>(pico - inicio.vivos), true);
+            }
+            anotar(memoria_[MEM_PICO_RSS_KB], f, pico_rss, true);
+            memoria::reiniciar_pico();
+        }
+        contabilidad_fin(f);
+    }
+
+    // Tiempo (us) de la fase medido por otros medios
+    void registrar(std::string const& fase, double us) {
+        registrar(indice(fase), us, std::numeric_limits<double>::quiet_NaN());
+    }
+
+    // Tiempo de la fase en la iteración actual (NaN si aún no se ha medido o si es de calentamiento)
+    double ultimo(std::string const& fase) const {
+        return calentando() || filas_.empty() ? std::numeric_limits<double>::quiet_NaN() : filas_.back()[indice(fase)];
+    }
+
+    std::vector<std::string> const& fases() const { return fases_; }
+
+    estadisticos resumen(std::string const& fase) const { return resumir(muestras(filas_, indice(fase))); }
+
+    // Los mismos estadísticos en ciclos (n = 0 sin TSC)
+    estadisticos resumen_ciclos(std::string const& fase) const { return resumir(muestras(ciclos_, indice(fase))); }
+
+    // Los mismos estadísticos del contador hardware número e de eventos_hw() (n = 0 sin contadores)
+    estadisticos resumen_hw(size_t e, std::string const& fase) const { return resumir(muestras(hw_[e], indice(fase))); }
+
+    // Los mismos estadísticos de una medida de memoria (n = 0 sin BENCH_MEMORIA)
+    estadisticos resumen_memoria(medida_memoria m, std::string const& fase) const {
+        return resumir(muestras(memoria_[m], indice(fase)));
+    }
+
+    // Una fila por iteración guardada: libreria,iteracion,grupo,tiempos...
+    // (las fases que no se han medido quedan vacías)
+    void escribir_iteraciones(std::string const& fichero, std::string const& libreria, std::string const& grupo) const {
+        std::ofstream csv(fichero, std::ios::out | std::ios::app);
+        for (size_t i = 0; i < filas_.size(); i++) {
+            csv << libreria << "," << i << "," << grupo;
+            for (double t : filas_[i]) {
+                csv << ",";
+                if (!std::isnan(t)) {
+                    csv << t;
+                }
+            }
+            csv << "\n";
+        }
+    }
+
+    // Una fila por fase medida:
+    // libreria,grupo,fase,n,media,desviacion,mediana,ic95_inf,ic95_sup,p90,p99,atipicos,mediana_ciclos,
+    // la mediana por operación de cada contador de eventos_hw(), y la mediana de
+    // reservas, bytes reservados, pico del heap (bytes) y pico de RSS (kB), y
+    // elementos,ranuras,grado si se ha llamado a carga() y mediana_por_elemento (us)
+    // si además la fase es de las que se reparten entre los elementos
+    void escribir_resumen(std::string const& fichero, std::string const& libreria, std::string const& grupo) const {
+        std::ofstream csv(fichero, std::ios::out | std::ios::app);
+        for (std::string const& fase : fases_) {
+            estadisticos e = resumen(fase);
+            if (e.n == 0) {
+                continue;
+            }
+            csv << libreria << "," << grupo << "," << fase << "," << e.n << "," << e.media << "," << e.desviacion << ","
+                << e.mediana << "," << e.ic_inf << "," << e.ic_sup << "," << e.p90 << "," << e.p99 << "," << e.atipicos
+                << ",";
+            estadisticos ciclos = resumen_ciclos(fase);
+            if (ciclos.n != 0) {
+                csv << ciclos.mediana;
+            }
+            for (size_t e = 0; e < hw_.size(); e++) {
+                csv << ",";
+                estadisticos hw = resumen_hw(e, fase);
+                if (hw.n != 0) {
+                    csv << hw.mediana;
+                }
+            }
+            for (size_t m = 0; m < N_MEDIDAS_MEMORIA; m++) {
+                csv << ",";
+                estadisticos medida = resumen_memoria(static_cast<medida_memoria>(m), fase);
+                if (medida.n != 0) {
+                    csv << medida.mediana;
+                }
+            }
+            csv << ",";
+            if (elementos_ != 0) {
+                csv << elementos_ << "," << ranuras_ << "," << grado_ << ",";
+                if (por_elemento_[indice(fase)]) {
+                    csv << e.mediana / elementos_;
+                }
+            } else {
+                csv << ",,,";
+            }
+            csv << "\n";
+        }
+    }
+
+private:
+    std::vector<std::string> fases_;
+    config config_;
+    std::vector<cycle_timer> timers_;
+    std::vector<std::unique_ptr<perf_counters>> contadores_; // Vacío si no se usan contadores
+    reloj::time_point inicio_iteracion_;
+    std::vector<std::vector<double>> filas_, ciclos_; // us y ciclos por iteración guardada
+    std::vector<std::vector<std::vector<double>>> hw_; // Por contador, como filas_
+    std::vector<std::vector<std::vector<double>>> memoria_; // Por medida_memoria, como filas_
+    std::vector<memoria::instantanea> inicio_memoria_; // Al empezar cada fase
+    std::vector<bool> abierta_; // Fases entre start() y stop()
+    std::vector<int64_t> pico_heap_anidado_; // Picos de la fase antes de que una fase anidada los reinicie
+    std::vector<long> pico_rss_anidado_;
+    // Lo que hace el harness dentro de una fase abierta (start() y stop() de
+    // las anidadas) y se descuenta de ella
+    std::vector<double> descuento_ns_, descuento_ciclos_;
+    std::vector<uint64_t> descuento_reservas_, descuento_bytes_;
+    cycle_timer contabilidad_;
+    memoria::instantanea contabilidad_memoria_;
+    bool contabilidad_anidada_ = false;
+    size_t llamadas_ = 0;
+    size_t elementos_ = 0, ranuras_ = 0, grado_ = 0; // carga()
+    std::vector<bool> por_elemento_; // Fases con coste por elemento (carga())
+    double tiempo_medido_us_ = 0;
+
+    size_t indice(char const* fase) const {
+        for (size_t f = 0; f < fases_.size(); f++) {
+            if (std::strcmp(fases_[f].c_str(), fase) == 0) {
+                return f;
+            }
+        }
+        throw std::invalid_argument(std::string("bench::harness: fase desconocida ") + fase);
+    }
+    size_t indice(std::string const& fase) const { return indice(fase.c_str()); }
+
+    // Empieza un trozo de trabajo del harness: si hay fases abiertas se paran
+    // sus contadores hardware y se mide el trozo para descontárselo
+    void contabilidad_inicio() {
+        contabilidad_anidada_ = false;
+        for (size_t o = 0; o < fases_.size(); o++) {
+            if (abierta_[o]) {
+                contabilidad_anidada_ = true;
+                if (!contadores_.empty()) {
+                    contadores_[o]->pausar();
+                }
+            }
+        }
+        if (contabilidad_anidada_) {
+            contabilidad_memoria_ = memoria::ahora();
+            contabilidad_.start();
+        }
+    }
+
+    // Termina el trozo y lo descuenta de las fases abiertas que no son f
+    void contabilidad_fin(size_t f) {
+        if (!contabilidad_anidada_) {
+            return;
+        }
+        timer_sample trozo = contabilidad_.stop();
+        memoria::instantanea despues = memoria::ahora();
+        for (size_t o = 0; o < fases_.size(); o++) {
+            if (!abierta_[o] || o == f) {
+                continue;
+            }
+            descuento_ns_[o] += trozo.ns;
+            descuento_ciclos_[o] += trozo.cycles;
+            descuento_reservas_[o] += despues.reservas - contabilidad_memoria_.reservas;
+            descuento_bytes_[o] += despues.bytes - contabilidad_memoria_.bytes;
+            if (!contadores_.empty()) {
+                contadores_[o]->reanudar();
+            }
+        }
+    }
+
+    static void acumular(double& total, double valor) {
+        if (!std::isnan(valor)) {
+            total = std::isnan(total) ? valor : total + valor;
+        }
+    }
+
+    void registrar(size_t f, double us, double ciclos) {
+        if (calentando() || filas_.empty()) {
+            return;
+        }
+        acumular(filas_.back()[f], us);
+        acumular(ciclos_.back()[f], ciclos);
+    }
+
+    // Anota el valor de la fase en la iteración actual de filas (sumando, o
+    // quedándose con el máximo si es un pico)
+    void anotar(std::vector<std::vector<double>>& filas, size_t f, double valor, bool maximo = false) {
+        if (calentando() || filas.empty()) {
+            return;
+        }
+        double& total = filas.back()[f];
+        if (maximo && !std::isnan(total)) {
+            total = std::max(total, valor);
+        } else {
+            acumular(total, valor);
+        }
+    }
+
+    static std::vector<double> muestras(std::vector<std::vector<double>> const& filas, size_t f) {
+        std::vector<double> m;
+        for (std::vector<double> const& fila : filas) {
+            if (!std::isnan(fila[f])) {
+                m.push_back(fila[f]);
+            }
+        }
+        return m;
+    }
+};
+
+} // namespace bench
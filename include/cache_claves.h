@@ -0,0 +1,101 @@
+#pragma once
+
+// Caché en disco de contextos y claves. Cada conjunto de parámetros tiene su
+// directorio, <BENCH_CACHE_DIR>/<libreria>_<huella>, donde la huella es un
+// hash de la descripción de los parámetros (que incluye la versión de la
+// librería si se conoce). Lo que hay en el directorio lo escribe y lo lee cada
+// programa con la serialización de su librería; aquí solo se decide si hay
+// que generar o cargar. El directorio se da por completo cuando tiene el
+// fichero "completa", que se escribe al final, así que una ejecución que se
+// corta a medias no deja una entrada que luego no se pueda cargar.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+
+namespace cache {
+
+// Directorio de la caché (BENCH_CACHE_DIR, por defecto cache_claves)
+inline std::string directorio() {
+    char const* texto = std::getenv("BENCH_CACHE_DIR");
+    return texto != nullptr && *texto != '\0' ? texto : "cache_claves";
+}
+
+// FNV-1a de 64 bits en hexadecimal
+inline std::string huella(std::string const& parametros) {
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : parametros) {
+        h = (h ^ c) * 1099511628211ULL;
+    }
+    char texto[17];
+    std::snprintf(texto, sizeof(texto), "%016llx", static_cast<unsigned long long>(h));
+    return texto;
+}
+
+inline void crear_directorio(std::string const& ruta) {
+    if (mkdir(ruta.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("cache: no se puede crear " + ruta);
+    }
+}
+
+// Directorio de la entrada (terminado en '/'); lo crea si no existe
+inline std::string entrada(std::string const& libreria, std::string const& parametros) {
+    std::string raiz = directorio();
+    crear_directorio(raiz);
+    std::string ruta = raiz + "/" + libreria + "_" + huella(parametros);
+    crear_directorio(ruta);
+    return ruta + "/";
+}
+
+inline bool completa(std::string const& entrada) {
+    return std::ifstream(entrada + "completa").good();
+}
+
+inline void marcar_completa(std::string const& entrada) {
+    std::ofstream(entrada + "completa") << "1\n";
+}
+
+// Borra los ficheros de la entrada (para medir un arranque en frío)
+inline void borrar(std::string const& entrada) {
+    DIR* dir = opendir(entrada.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    std::remove((entrada + "completa").c_str());
+    while (dirent* f = readdir(dir)) {
+        std::string nombre = f->d_name;
+        if (nombre != "." && nombre != "..") {
+            std::remove((entrada + nombre).c_str());
+        }
+    }
+    closedir(dir);
+}
+
+// Carga T de la entrada si está completa; si no, lo genera y lo guarda.
+// cargado dice cuál de los dos caminos se ha seguido.
+template <class T>
+T obtener(std::string const& entrada, std::function<T()> const& generar,
+          std::function<void(T const&)> const& guardar, std::function<T()> const& cargar, bool* cargado = nullptr) {
+    if (completa(entrada)) {
+        if (cargado != nullptr) {
+            *cargado = true;
+        }
+        return cargar();
+    }
+    T valor = generar();
+    guardar(valor);
+    marcar_completa(entrada);
+    if (cargado != nullptr) {
+        *cargado = false;
+    }
+    return valor;
+}
+
+} // namespace cache
@@ -0,0 +1,296 @@
+#pragma once
+
+// Circuitos homomórficos como grafos de operaciones (DAG). Se construyen una
+// vez con las entradas y las operaciones binarias que dependen de ellas, y se
+// ejecutan en orden de dependencias, en serie o sobre un conjunto de hilos con
+// robo de trabajo: cada hilo tiene su cola de nodos listos, saca por el final
+// los que él mismo ha desbloqueado (los operandos siguen en su caché) y, si se
+// queda sin trabajo, roba por el principio de las colas de los demás. Si
+// tampoco hay nada que robar, espera a que algún nodo quede listo sin ocupar
+// el núcleo.
+// Cada resultado intermedio se libera en cuanto termina su último consumidor
+// (o nada más calcularse, si no lo usa nadie ni es salida), así que la memoria
+// no crece con el tamaño del circuito sino con su anchura.
+// No depende de la librería: T es el tipo del criptograma (FV::ciphertext_t,
+// Ciphertext<DCRTPoly>, helib::Ctxt...) y las operaciones son funciones
+// T(T const&, T const&) que se pueden llamar desde varios hilos a la vez.
+//
+//   circuito<FV::ciphertext_t> c;
+//   auto a = c.entrada(ca), b = c.entrada(cb), d = c.entrada(cd), e = c.entrada(ce);
+//   auto r = c.operar(suma, c.operar(mul, a, b), c.operar(mul, d, e));
+//   c.salida(r);
+//   c.ejecutar(4);  // a*b y d*e a la vez
+//   c.valor(r);
+//
+// Hace falta -pthread.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+template <class T>
+class circuito {
+public:
+    using operacion = std::function<T(T const&, T const&)>;
+    using nodo_id = size_t;
+
+    // Entrada del circuito (no se libera al ejecutar)
+    nodo_id entrada(T valor) {
+        nodos_.push_back(nodo());
+        nodos_.back().valor.reset(new T(std::move(valor)));
+        return nodos_.size() - 1;
+    }
+
+    // op(a, b) sobre dos nodos ya creados
+    nodo_id operar(operacion op, nodo_id a, nodo_id b) {
+        if (a >= nodos_.size() || b >= nodos_.size()) {
+            throw std::out_of_range("circuito: operando inexistente");
+        }
+        nodos_.push_back(nodo());
+        nodo& n = nodos_.back();
+        n.op = std::move(op);
+        n.operandos[0] = a;
+        n.operandos[1] = b;
+        nodos_[a].consumidores.push_back(nodos_.size() - 1);
+        nodos_[b].consumidores.push_back(nodos_.size() - 1);
+        return nodos_.size() - 1;
+    }
+
+    // Marca un nodo como resultado: se conserva tras ejecutar
+    void salida(nodo_id n) { nodos_.at(n).salida = true; }
+
+    // Valor de una entrada o de una salida tras ejecutar
+    T const& valor(nodo_id n) const {
+        if (!nodos_.at(n).valor) {
+            throw std::logic_error("circuito: el nodo no tiene valor (no es salida o no se ha ejecutado)");
+        }
+        return *nodos_[n].valor;
+    }
+
+    size_t size() const { return nodos_.size(); }
+    size_t operaciones() const {
+        return std::count_if(nodos_.begin(), nodos_.end(), [](nodo const& n) { return bool(n.op); });
+    }
+
+    // Máximo de resultados intermedios vivos a la vez en la última ejecución
+    size_t pico_vivos() const { return pico_vivos_; }
+
+    // Ejecuta el circuito con hilos hilos (0: uno por hilo hardware). Con un
+    // hilo se recorren los nodos en el orden en que se crearon, sin colas.
+    void ejecutar(size_t hilos = 1) {
+        if (hilos == 0) {
+            hilos = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        preparar();
+        if (hilos == 1) {
+            for (nodo_id n = 0; n < nodos_.size(); n++) {
+                if (nodos_[n].op) {
+                    evaluar(n, nullptr);
+                }
+            }
+            pico_vivos_ = pico_;
+            return;
+        }
+
+        colas_ = std::vector<cola>(hilos);
+        size_t siguiente = 0;
+        for (nodo_id n = 0; n < nodos_.size(); n++) {
+            if (nodos_[n].op && nodos_[n].faltan == 0) {
+                colas_[siguiente++ % hilos].nodos.push_back(n);
+            }
+        }
+        listos_ = siguiente;
+        std::vector<std::thread> trabajadores;
+        for (size_t t = 1; t < hilos; t++) {
+            trabajadores.emplace_back([this, t] { trabajar(t); });
+        }
+        trabajar(0);
+        for (std::thread& t : trabajadores) {
+            t.join();
+        }
+        colas_.clear();
+        pico_vivos_ = pico_;
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    struct nodo {
+        operacion op; // Vacía en las entradas
+        nodo_id operandos[2];
+        std::vector<nodo_id> consumidores;
+        bool salida = false;
+        std::unique_ptr<T> valor;
+        std::atomic<size_t> faltan{0}; // Operandos que aún no están calculados
+        std::atomic<size_t> usos{0};   // Consumidores que aún no han terminado
+
+        nodo() {}
+        // Solo se copian nodos al construir el circuito, con los contadores a 0
+        nodo(nodo&& otro)
+            : op(std::move(otro.op)), consumidores(std::move(otro.consumidores)),
+              salida(otro.salida), valor(std::move(otro.valor)) {
+            operandos[0] = otro.operandos[0];
+            operandos[1] = otro.operandos[1];
+        }
+    };
+
+    struct cola {
+        std::mutex mutex;
+        std::deque<nodo_id> nodos;
+    };
+
+    std::deque<nodo> nodos_;
+    std::vector<cola> colas_;
+    std::atomic<size_t> restantes_{0}, vivos_{0};
+    size_t pico_vivos_ = 0;
+    std::atomic<size_t> pico_{0};
+    std::atomic<bool> abortar_{false};
+    std::mutex mutex_error_;
+    std::exception_ptr error_;
+    // Hilos sin trabajo: esperan a que haya nodos en las colas (listos_), a que
+    // se acabe el circuito o a que falle una operación
+    std::atomic<size_t> listos_{0}, dormidos_{0};
+    std::mutex mutex_espera_;
+    std::condition_variable hay_trabajo_;
+
+    void preparar() {
+        size_t pendientes = 0;
+        for (nodo& n : nodos_) {
+            if (n.op) {
+                n.valor.reset();
+                n.faltan = 2;
+                pendientes++;
+            }
+            n.usos = n.consumidores.size();
+        }
+        for (nodo& n : nodos_) {
+            if (!n.op) {
+                for (nodo_id c : n.consumidores) {
+                    nodos_[c].faltan--;
+                }
+            }
+        }
+        restantes_ = pendientes;
+        listos_ = 0;
+        vivos_ = 0;
+        pico_ = 0;
+        error_ = nullptr;
+        abortar_ = false;
+    }
+
+    // Calcula el nodo, desbloquea a sus consumidores (a la cola propia) y
+    // libera los operandos de los que era el último consumidor, y el propio
+    // resultado si nadie lo va a usar
+    void evaluar(nodo_id id, cola* propia) {
+        nodo& n = nodos_[id];
+        n.valor.reset(new T(n.op(*nodos_[n.operandos[0]].valor, *nodos_[n.operandos[1]].valor)));
+        size_t vivos = ++vivos_;
+        size_t pico = pico_.load();
+        while (vivos > pico && !pico_.compare_exchange_weak(pico, vivos)) {
+        }
+
+        for (nodo_id c : n.consumidores) {
+            if (--nodos_[c].faltan == 0 && propia) {
+                {
+                    std::lock_guard<std::mutex> lock(propia->mutex);
+                    propia->nodos.push_back(c);
+                    listos_++;
+                }
+                despertar(false);
+            }
+        }
+        for (nodo_id o : n.operandos) {
+            nodo& operando = nodos_[o];
+            if (--operando.usos == 0 && operando.op && !operando.salida) {
+                operando.valor.reset();
+                vivos_--;
+            }
+        }
+        if (n.consumidores.empty() && !n.salida) {
+            n.valor.reset();
+            vivos_--;
+        }
+    }
+
+    // Despierta a un hilo que espera trabajo (o a todos, al terminar). Solo
+    // toma el mutex si hay alguno esperando: el hilo que se va a dormir
+    // anota dormidos_ antes de mirar listos_, y aquí se mira dormidos_
+    // después de anotar listos_, así que uno de los dos ve al otro.
+    void despertar(bool todos) {
+        if (dormidos_ == 0) {
+            return;
+        }
+        { std::lock_guard<std::mutex> lock(mutex_espera_); }
+        if (todos) {
+            hay_trabajo_.notify_all();
+        } else {
+            hay_trabajo_.notify_one();
+        }
+    }
+
+    void esperar() {
+        std::unique_lock<std::mutex> lock(mutex_espera_);
+        dormidos_++;
+        hay_trabajo_.wait(lock, [this] { return listos_ > 0 || restantes_ == 0 || abortar_; });
+        dormidos_--;
+    }
+
+    bool sacar(size_t hilo, nodo_id& id) {
+        cola& propia = colas_[hilo];
+        {
+            std::lock_guard<std::mutex> lock(propia.mutex);
+            if (!propia.nodos.empty()) {
+                id = propia.nodos.back();
+                propia.nodos.pop_back();
+                listos_--;
+                return true;
+            }
+        }
+        for (size_t i = 1; i < colas_.size(); i++) {
+            cola& victima = colas_[(hilo + i) % colas_.size()];
+            std::lock_guard<std::mutex> lock(victima.mutex);
+            if (!victima.nodos.empty()) {
+                id = victima.nodos.front();
+                victima.nodos.pop_front();
+                listos_--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void trabajar(size_t hilo) {
+        while (restantes_ > 0 && !abortar_) {
+            nodo_id id;
+            if (!sacar(hilo, id)) {
+                esperar();
+                continue;
+            }
+            try {
+                evaluar(id, &colas_[hilo]);
+                if (--restantes_ == 0) {
+                    despertar(true);
+                }
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_error_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                    abortar_ = true;
+                }
+                despertar(true);
+            }
+        }
+    }
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+// Medidas de memoria para los benchmarks: reservas del heap, pico de RSS y
+// tamaño serializado de claves y criptogramas.
+//
+// Las reservas se cuentan interponiendo malloc, calloc, realloc, free,
+// posix_memalign, aligned_alloc y memalign sobre las funciones internas de
+// glibc (__libc_malloc...). Así se ven las de operator new, las de GMP y las
+// de NFLlib, OpenFHE y HElib sin tocarlas. Solo se cuenta mientras la cuenta
+// está activada (activar()), y entonces cada reserva cuesta unas operaciones
+// atómicas más. Fuera de glibc, o compilando con sanitizers, no se interpone
+// nada y interpuesto() devuelve false.
+// Las funciones interpuestas se definen aquí, así que este fichero (o
+// benchmark.h, que lo incluye) solo puede incluirse en un fichero de cada
+// programa, como hacen todos los test_*.cpp.
+//
+// El pico de RSS de un bloque se mide reiniciando VmHWM con
+// /proc/self/clear_refs (Linux >= 4.0) y leyéndolo de /proc/self/status al
+// terminar; si no se puede reiniciar es el pico del proceso (getrusage).
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <sys/resource.h>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define MEMORIA_INTERPONER 1
+#include <malloc.h>
+#endif
+
+namespace memoria {
+
+struct contadores {
+    std::atomic<bool> activo;
+    std::atomic<uint64_t> reservas; // Llamadas que reservan
+    std::atomic<uint64_t> bytes;    // Bytes pedidos
+    std::atomic<int64_t> vivos;     // Bytes reservados y no liberados (según malloc_usable_size)
+    std::atomic<int64_t> pico;      // Máximo de vivos desde reiniciar_pico()
+};
+
+// Inicializados a cero antes de cualquier llamada a malloc
+inline contadores& estado() {
+    static contadores c;
+    return c;
+}
+
+inline bool interpuesto() {
+#ifdef MEMORIA_INTERPONER
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void activar(bool activo) { estado().activo.store(activo, std::memory_order_relaxed); }
+
+struct instantanea {
+    uint64_t reservas;
+    uint64_t bytes;
+    int64_t vivos;
+};
+
+inline instantanea ahora() {
+    contadores& c = estado();
+    return {c.reservas.load(std::memory_order_relaxed), c.bytes.load(std::memory_order_relaxed),
+            c.vivos.load(std::memory_order_relaxed)};
+}
+
+inline void reiniciar_pico() {
+    contadores& c = estado();
+    c.pico.store(c.vivos.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+inline int64_t pico() { return estado().pico.load(std::memory_order_relaxed); }
+
+namespace detalle {
+
+inline void sumar_vivos(int64_t bytes) {
+    contadores& c = estado();
+    int64_t vivos = c.vivos.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t pico = c.pico.load(std::memory_order_relaxed);
+    while (vivos > pico && !c.pico.compare_exchange_weak(pico, vivos, std::memory_order_relaxed)) {
+    }
+}
+
+// Reserva de n bytes que ha devuelto p, que sustituye a otra de antes bytes
+inline void reservado(void* p, size_t n, size_t antes = 0) {
+#ifdef MEMORIA_INTERPONER
+    contadores& c = estado();
+    if (p == nullptr || !c.activo.load(std::memory_order_relaxed)) {
+        return;
+    }
+    c.reservas.fetch_add(1, std::memory_order_relaxed);
+    c.bytes.fetch_add(n, std::memory_order_relaxed);
+    sumar_vivos(static_cast<int64_t>(malloc_usable_size(p)) - static_cast<int64_t>(antes));
+#else
+    (void)p, (void)n, (void)antes;
+#endif
+}
+
+inline void liberado(void* p) {
+#ifdef MEMORIA_INTERPONER
+    if (p != nullptr && estado().activo.load(std::memory_order_relaxed)) {
+        sumar_vivos(-static_cast<int64_t>(malloc_usable_size(p)));
+    }
+#else
+    (void)p;
+#endif
+}
+
+} // namespace detalle
+
+// Reinicia el pico de RSS (VmHWM); false si el kernel no lo permite
+inline bool reiniciar_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+}
+
+// Pico de RSS en kB desde reiniciar_rss() (o desde el inicio del proceso)
+inline long pico_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string linea;
+    while (std::getline(status, linea)) {
+        if (linea.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtol(linea.c_str() + 6, nullptr, 10);
+        }
+    }
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+// streambuf que solo cuenta los bytes, para medir un objeto serializado sin guardarlo
+class contador_buf : public std::streambuf {
+public:
+    size_t bytes() const { return bytes_; }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            bytes_++;
+        }
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(char const*, std::streamsize n) override {
+        bytes_ += n;
+        return n;
+    }
+
+private:
+    size_t bytes_ = 0;
+};
+
+// Bytes que escribe escribir(std::ostream&)
+template <class F>
+size_t tamano_serializado(F escribir) {
+    contador_buf buf;
+    std::ostream salida(&buf);
+    escribir(salida);
+    return buf.bytes();
+}
+
+// Añade la fila libreria,grupo,objeto,bytes
+inline void escribir_tamano(std::string const& fichero, std::string const& libreria, std::string const& grupo,
+                            std::string const& objeto, size_t bytes) {
+    std::ofstream csv(fichero, std::ios::out | std::ios::app);
+    csv << libreria << "," << grupo << "," << objeto << "," << bytes << "\n";
+}
+
+} // namespace memoria
+
+#ifdef MEMORIA_INTERPONER
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+
+void* malloc(size_t n) {
+    void* p = __libc_malloc(n);
+    memoria::detalle::reservado(p, n);
+    return p;
+}
+
+void* calloc(size_t n, size_t tamano) {
+    void* p = __libc_calloc(n, tamano);
+    memoria::detalle::reservado(p, n * tamano);
+    return p;
+}
+
+void* realloc(void* p, size_t n) {
+    size_t antes = p != nullptr && memoria::estado().activo.load(std::memory_order_relaxed) ? malloc_usable_size(p) : 0;
+    void* q = __libc_realloc(p, n);
+    if (q != nullptr) {
+        memoria::detalle::reservado(q, n, antes);
+    } else if (n == 0) {
+        memoria::detalle::sumar_vivos(-static_cast<int64_t>(antes));
+    }
+    return q;
+}
+
+void free(void* p) {
+    memoria::detalle::liberado(p);
+    __libc_free(p);
+}
+
+void* memalign(size_t alineamiento, size_t n) {
+    void* p = __libc_memalign(alineamiento, n);
+    memoria::detalle::reservado(p, n);
+    return p;
+}
+
+void* aligned_alloc(size_t alineamiento, size_t n) { return memalign(alineamiento, n); }
+
+int posix_memalign(void** p, size_t alineamiento, size_t n) {
+    if (alineamiento % sizeof(void*) != 0 || (alineamiento & (alineamiento - 1)) != 0) {
+        return EINVAL;
+    }
+    void* q = memalign(alineamiento, n);
+    if (q == nullptr && n != 0) {
+        return ENOMEM;
+    }
+    *p = q;
+    return 0;
+}
+}
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+// Contadores hardware de Linux (perf_event_open) para medir fallos de caché y
+// de TLB alrededor de un bloque de código. Si el kernel no los permite
+// (contenedores, perf_event_paranoid alto, máquina virtual) el contador queda
+// marcado como no disponible y su lectura devuelve -1.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct perf_evento {
+    const char* nombre; // Nombre de la columna en el CSV
+    uint32_t tipo;
+    uint64_t config;
+};
+
+// Eventos genéricos del kernel, disponibles en cualquier CPU con PMU
+inline perf_evento perf_cache_dato(const char* nombre, uint64_t cache, uint64_t op, uint64_t resultado) {
+    return {nombre, PERF_TYPE_HW_CACHE, cache | (op << 8) | (resultado << 16)};
+}
+
+const perf_evento PERF_CICLOS = {"ciclos", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+const perf_evento PERF_INSTRUCCIONES = {"instrucciones", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+const perf_evento PERF_FALLOS_LLC = {"fallos_llc", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+const perf_evento PERF_FALLOS_SALTO = {"fallos_salto", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+const perf_evento PERF_FALLOS_L1D = perf_cache_dato("fallos_l1d", PERF_COUNT_HW_CACHE_L1D,
+    PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+const perf_evento PERF_FALLOS_DTLB = perf_cache_dato("fallos_dtlb", PERF_COUNT_HW_CACHE_DTLB,
+    PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+
+class perf_counters {
+public:
+    explicit perf_counters(std::vector<perf_evento> const& eventos) : eventos_(eventos), fds_(eventos.size(), -1), valores_(eventos.size(), -1) {
+        for (size_t i = 0; i < eventos_.size(); i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = eventos_[i].tipo;
+            attr.config = eventos_[i].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // Cada contador va por separado: si la PMU no tiene sitio para todos
+            // a la vez el kernel multiplexa y se escala con time_enabled/running
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    ~perf_counters() {
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    perf_counters(perf_counters const&) = delete;
+    perf_counters& operator=(perf_counters const&) = delete;
+
+    // true si al menos un contador se ha podido abrir
+    bool disponible() const {
+        for (int fd : fds_) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    void start() {
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void stop() {
+        for (size_t i = 0; i < fds_.size(); i++) {
+            if (fds_[i] < 0) continue;
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t lectura[3] = {0, 0, 0}; // valor, time_enabled, time_running
+            if (read(fds_[i], lectura, sizeof(lectura)) != sizeof(lectura) || lectura[2] == 0) {
+                valores_[i] = -1;
+                continue;
+            }
+            valores_[i] = static_cast<int64_t>(static_cast<long double>(lectura[0]) * lectura[1] / lectura[2]);
+        }
+    }
+
+    // Para y reanuda la cuenta sin reiniciarla, para dejar fuera un trozo de la medida
+    void pausar() {
+        for (int fd : fds_) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    void reanudar() {
+        for (int fd : fds_) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    size_t size() const { return eventos_.size(); }
+    const char* nombre(size_t i) const { return eventos_[i].nombre; }
+    // Valor de la última medida, -1 si el contador no está disponible
+    int64_t valor(size_t i) const { return valores_[i]; }
+
+    // Cabecera y valores separados por comas para añadir al CSV
+    std::string cabecera_csv() const {
+        std::string s;
+        for (size_t i = 0; i < eventos_.size(); i++) {
+            s += std::string(i ? "," : "") + eventos_[i].nombre;
+        }
+        return s;
+    }
+    std::string valores_csv() const {
+        std::string s;
+        for (size_t i = 0; i < valores_.size(); i++) {
+            s += (i ? "," : "") + std::to_string(valores_[i]);
+        }
+        return s;
+    }
+
+private:
+    std::vector<perf_evento> eventos_;
+    std::vector<int> fds_;
+    std::vector<int64_t> valores_;
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+// Coste y ruido en función de la profundidad multiplicativa, con cualquier
+// adaptador de include/backend.h. Se ejecutan tres circuitos nivel a nivel:
+//   cadena          x_0 * x_1 * ... * x_k, una multiplicación por nivel
+//   arbol           producto en árbol equilibrado de 2^k hojas
+//   suma_productos  s_k = s_{k-1} * x_{k,1} + ... + s_{k-1} * x_{k,terminos}
+// De cada nivel se escribe en el CSV el tiempo de sus operaciones (sin el
+// cifrado de las entradas), el presupuesto de ruido que queda y si descifra
+// bien. Un circuito se detiene en el primer nivel que no descifra bien o en el
+// que la librería lanza una excepción (por ejemplo, OpenFHE sin niveles).
+// Los niveles se miden con cycle_timer (tools.h), como las fases del harness,
+// y antes de las repeticiones se hace una de calentamiento que no se escribe
+// (salvo con BENCH_CALENTAMIENTO=0).
+//
+// Columnas: Libreria,Iteracion,Sec_Level,Circuito,Nivel,T_nivel,Presupuesto_bits,Correcto
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tools.h"
+#include "benchmark.h"
+
+namespace bench {
+
+template <class B>
+class circuitos_profundidad {
+public:
+    using cifrado = typename B::cifrado;
+    using valores = std::vector<int64_t>;
+
+    circuitos_profundidad(B const& backend, std::string const& fichero, std::string const& grupo)
+        : backend_(backend), csv_(fichero, std::ios::out | std::ios::app), grupo_(grupo),
+          elementos_(config::entorno().llenar ? backend.ranuras() : 10) {}
+
+    // Con calentar(true) los circuitos se ejecutan igual pero no se escriben en el CSV
+    void calentar(bool calentando) { calentando_ = calentando; }
+
+    // Cada función devuelve el último nivel que descifra bien
+    int cadena(int iteracion, int maximo) {
+        valores esperado = mensaje();
+        cifrado acumulado = cifrar(esperado);
+        for (int k = 1; k <= maximo; k++) {
+            valores m = mensaje();
+            cifrado factor = cifrar(m);
+            try {
+                timer_.start();
+                cifrado siguiente = backend_.relinealizar(backend_.multiplicar(acumulado, factor));
+                double tiempo_us = timer_.stop().ns / 1e3;
+                acumulado = std::move(siguiente);
+                esperado = backend_.producto_claro(esperado, m);
+                if (!anotar("cadena", iteracion, k, tiempo_us, {&acumulado}, {&esperado})) {
+                    return k - 1;
+                }
+            } catch (std::exception const& e) {
+                return fallo("cadena", iteracion, k, e);
+            }
+        }
+        return maximo;
+    }
+
+    int arbol(int iteracion, int maximo) {
+        std::vector<cifrado> nodos;
+        std::vector<valores> esperados;
+        for (size_t i = 0; i < (size_t(1) << maximo); i++) {
+            esperados.push_back(mensaje());
+            nodos.push_back(cifrar(esperados.back()));
+        }
+        for (int k = 1; k <= maximo; k++) {
+            try {
+                std::vector<cifrado> siguientes;
+                timer_.start();
+                for (size_t i = 0; i + 1 < nodos.size(); i += 2) {
+                    siguientes.push_back(backend_.relinealizar(backend_.multiplicar(nodos[i], nodos[i + 1])));
+                }
+                double tiempo_us = timer_.stop().ns / 1e3;
+                std::vector<valores> siguientes_esperados;
+                for (size_t i = 0; i + 1 < esperados.size(); i += 2) {
+                    siguientes_esperados.push_back(backend_.producto_claro(esperados[i], esperados[i + 1]));
+                }
+                nodos = std::move(siguientes);
+                esperados = std::move(siguientes_esperados);
+                std::vector<cifrado const*> c;
+                std::vector<valores const*> e;
+                for (size_t i = 0; i < nodos.size(); i++) {
+                    c.push_back(&nodos[i]);
+                    e.push_back(&esperados[i]);
+                }
+                if (!anotar("arbol", iteracion, k, tiempo_us, c, e)) {
+                    return k - 1;
+                }
+            } catch (std::exception const& e) {
+                return fallo("arbol", iteracion, k, e);
+            }
+        }
+        return maximo;
+    }
+
+    int suma_productos(int iteracion, int maximo, int terminos) {
+        valores esperado = mensaje();
+        cifrado acumulado = cifrar(esperado);
+        for (int k = 1; k <= maximo; k++) {
+            std::vector<valores> m;
+            std::vector<cifrado> x;
+            for (int j = 0; j < terminos; j++) {
+                m.push_back(mensaje());
+                x.push_back(cifrar(m.back()));
+            }
+            try {
+                timer_.start();
+                cifrado suma = backend_.relinealizar(backend_.multiplicar(acumulado, x[0]));
+                for (int j = 1; j < terminos; j++) {
+                    suma = backend_.sumar(suma, backend_.relinealizar(backend_.multiplicar(acumulado, x[j])));
+                }
+                double tiempo_us = timer_.stop().ns / 1e3;
+                acumulado = std::move(suma);
+                valores siguiente = backend_.producto_claro(esperado, m[0]);
+                for (int j = 1; j < terminos; j++) {
+                    siguiente = sumar_claro(siguiente, backend_.producto_claro(esperado, m[j]));
+                }
+                esperado = std::move(siguiente);
+                if (!anotar("suma_productos", iteracion, k, tiempo_us, {&acumulado}, {&esperado})) {
+                    return k - 1;
+                }
+            } catch (std::exception const& e) {
+                return fallo("suma_productos", iteracion, k, e);
+            }
+        }
+        return maximo;
+    }
+
+private:
+    valores mensaje() { return datos_aleatorios(elementos_, backend_.modulo(), semilla_++); }
+
+    cifrado cifrar(valores const& m) const { return backend_.cifrar(backend_.codificar(m)); }
+
+    valores sumar_claro(valores const& a, valores const& b) const {
+        valores c(a.size() > b.size() ? a : b);
+        valores const& corto = a.size() > b.size() ? b : a;
+        for (size_t i = 0; i < corto.size(); i++) {
+            c[i] = (c[i] + corto[i]) % backend_.modulo();
+        }
+        return c;
+    }
+
+    // Escribe la fila del nivel con el menor presupuesto de sus criptogramas y
+    // dice si todos descifran bien
+    bool anotar(char const* circuito, int iteracion, int nivel, double tiempo_us,
+                std::vector<cifrado const*> const& c, std::vector<valores const*> const& esperados) {
+        bool correcto = true;
+        double presupuesto = 0;
+        for (size_t i = 0; i < c.size(); i++) {
+            valores r = backend_.descifrar(*c[i]);
+            for (size_t j = 0; j < esperados[i]->size(); j++) {
+                correcto = correcto && r[j] == (*esperados[i])[j];
+            }
+            double p = backend_.presupuesto_ruido(*c[i], *esperados[i]);
+            presupuesto = (i == 0 || p < presupuesto) ? p : presupuesto;
+        }
+        if (!calentando_) {
+            csv_ << B::nombre() << "," << iteracion << "," << grupo_ << "," << circuito << "," << nivel << ","
+                 << tiempo_us << "," << presupuesto << "," << correcto << "\n";
+        }
+        return correcto;
+    }
+
+    int fallo(char const* circuito, int iteracion, int nivel, std::exception const& e) {
+        std::cout << B::nombre() << " " << grupo_ << " " << circuito << ", nivel " << nivel << ": " << e.what() << std::endl;
+        if (!calentando_) {
+            csv_ << B::nombre() << "," << iteracion << "," << grupo_ << "," << circuito << "," << nivel << ",,,0\n";
+        }
+        return nivel - 1;
+    }
+
+    B const& backend_;
+    std::ofstream csv_;
+    std::string grupo_;
+    size_t elementos_;
+    uint64_t semilla_ = 0;
+    cycle_timer timer_;
+    bool calentando_ = false;
+};
+
+// Ejecuta los tres circuitos repeticiones veces (más la de calentamiento) con
+// el mismo contexto y las mismas claves e imprime la profundidad a la que llega
+// cada uno. Devuelve 1 si algún circuito no pasa del primer nivel.
+template <class B>
+int ejecutar_profundidad(std::string const& fichero, int nivel_seguridad, int profundidad_maxima,
+                         int profundidad_arbol, int terminos, int repeticiones) {
+    B backend(nivel_seguridad, profundidad_maxima);
+    backend.generar_claves();
+    circuitos_profundidad<B> circuitos(backend, fichero, std::to_string(nivel_seguridad));
+    int const calentamiento = config::entorno().calentamiento > 0 ? 1 : 0;
+    int error = 0;
+    for (int i = -calentamiento; i < repeticiones; i++) {
+        circuitos.calentar(i < 0);
+        int cadena = circuitos.cadena(i, profundidad_maxima);
+        int arbol = circuitos.arbol(i, profundidad_arbol);
+        int suma_productos = circuitos.suma_productos(i, profundidad_maxima, terminos);
+        if (cadena < 1 || arbol < 1 || suma_productos < 1) {
+            error = 1;
+        }
+        if (i == 0) {
+            std::cout << B::nombre() << " " << nivel_seguridad << ": profundidad cadena " << cadena << "/" << profundidad_maxima
+                      << ", arbol " << arbol << "/" << profundidad_arbol << ", suma_productos " << suma_productos << "/"
+                      << profundidad_maxima << std::endl;
+        }
+    }
+    if (error) {
+        std::cout << "Error: " << B::nombre() << " " << nivel_seguridad << ": algún circuito no descifra bien en el primer nivel" << std::endl;
+    }
+    return error;
+}
+
+} // namespace bench
@@ -0,0 +1,155 @@
+#pragma once
+
+// Modo de rendimiento (throughput) de los benchmarks: T hilos atienden a la
+// vez flujos independientes de peticiones con las mismas claves y se mide el
+// total de peticiones por segundo, cómo escala con los hilos y la latencia de
+// cada petición.
+//
+//   bench::resultado_rendimiento r = bench::medir_rendimiento(hilos, peticiones, [&](size_t hilo) {
+//       // Se llama ya dentro del hilo, antes de empezar a medir: estado propio del hilo
+//       return [&]() { ... una petición ... };
+//   });
+//
+// Todos los hilos preparan su estado y esperan en una barrera; el tiempo va
+// desde que se abre la barrera hasta que termina el último hilo. Cada hilo
+// guarda las latencias en su propio vector, así que medir no añade
+// sincronización entre peticiones.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchmark.h"
+
+namespace bench {
+
+struct resultado_rendimiento {
+    size_t hilos = 0;
+    size_t peticiones = 0;         // Total de todos los hilos
+    double segundos = 0;
+    double peticiones_por_s = 0;
+    estadisticos latencia;         // Latencia de una petición (us), de todos los hilos juntos
+    double peor_p99_hilo = 0;      // El mayor percentil 99 de la latencia de un hilo (us)
+};
+
+// 1, 2, 4, ... hasta los hilos hardware (incluidos)
+inline std::vector<size_t> hilos_hasta_nucleos() {
+    std::vector<size_t> hilos;
+    size_t maximo = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    for (size_t h = 1; h < maximo; h *= 2) {
+        hilos.push_back(h);
+    }
+    hilos.push_back(maximo);
+    return hilos;
+}
+
+// Ejecuta peticiones_por_hilo peticiones en cada uno de los hilos. preparar(hilo)
+// devuelve la función que hace una petición en ese hilo. Si una petición lanza
+// una excepción, se relanza aquí cuando han terminado todos los hilos.
+template <class Preparar>
+resultado_rendimiento medir_rendimiento(size_t hilos, size_t peticiones_por_hilo, Preparar preparar) {
+    using reloj = std::chrono::steady_clock;
+    std::vector<std::vector<double>> latencias(hilos);
+    std::vector<std::exception_ptr> errores(hilos);
+    std::atomic<size_t> preparados(0);
+    std::atomic<bool> salida(false);
+
+    std::vector<std::thread> threads;
+    for (size_t h = 0; h < hilos; h++) {
+        threads.emplace_back([&, h]() {
+            bool listo = false;
+            try {
+                auto peticion = preparar(h);
+                latencias[h].reserve(peticiones_por_hilo);
+                listo = true;
+                preparados++;
+                while (!salida.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < peticiones_por_hilo; i++) {
+                    reloj::time_point inicio = reloj::now();
+                    peticion();
+                    latencias[h].push_back(std::chrono::duration<double, std::micro>(reloj::now() - inicio).count());
+                }
+            } catch (...) {
+                errores[h] = std::current_exception();
+                if (!listo) {
+                    preparados++; // Para no dejar esperando a la barrera si falla al preparar
+                }
+            }
+        });
+    }
+    while (preparados.load() < hilos) {
+        std::this_thread::yield();
+    }
+    reloj::time_point inicio = reloj::now();
+    salida.store(true, std::memory_order_release);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    reloj::time_point fin = reloj::now();
+    for (std::exception_ptr const& e : errores) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    resultado_rendimiento r;
+    r.hilos = hilos;
+    r.peticiones = hilos * peticiones_por_hilo;
+    r.segundos = std::chrono::duration<double>(fin - inicio).count();
+    r.peticiones_por_s = r.peticiones / r.segundos;
+    std::vector<double> todas;
+    for (std::vector<double> const& l : latencias) {
+        todas.insert(todas.end(), l.begin(), l.end());
+        r.peor_p99_hilo = std::max(r.peor_p99_hilo, resumir(l).p99);
+    }
+    r.latencia = resumir(todas);
+    return r;
+}
+
+// Barrido de hilos_hasta_nucleos() con repeticiones medidas para cada número
+// de hilos. Muestra la primera repetición y escribe una fila por repetición:
+// libreria,iteracion,grupo,hilos,peticiones_por_s,eficiencia,lat_mediana_us,lat_p90_us,lat_p99_us,peor_p99_hilo_us
+// La eficiencia es peticiones_por_s / (hilos * peticiones_por_s con un hilo),
+// con la media de las repeticiones de un hilo. Antes se hace una ronda de
+// calentamiento con un hilo que no se mide, para que los fallos de página, las
+// tablas de la NTT y las primeras reservas no caigan en esa base.
+template <class Preparar>
+void barrido_rendimiento(std::string const& fichero, std::string const& libreria, std::string const& grupo,
+                         size_t repeticiones, size_t peticiones_por_hilo, Preparar preparar) {
+    std::ofstream csv(fichero, std::ios::out | std::ios::app);
+    double base = 0;
+    medir_rendimiento(1, peticiones_por_hilo, preparar);
+    for (size_t hilos : hilos_hasta_nucleos()) {
+        std::vector<resultado_rendimiento> resultados;
+        for (size_t n = 0; n < repeticiones; n++) {
+            resultados.push_back(medir_rendimiento(hilos, peticiones_por_hilo, preparar));
+        }
+        if (hilos == 1) {
+            for (resultado_rendimiento const& r : resultados) {
+                base += r.peticiones_por_s / resultados.size();
+            }
+        }
+        for (size_t n = 0; n < resultados.size(); n++) {
+            resultado_rendimiento const& r = resultados[n];
+            double eficiencia = r.peticiones_por_s / (hilos * base);
+            if (n == 0) {
+                std::cout << libreria << " " << grupo << ", " << hilos << " hilos: " << r.peticiones_por_s
+                          << " peticiones/s, eficiencia " << eficiencia << ", latencia mediana " << r.latencia.mediana
+                          << " us, p99 " << r.latencia.p99 << " us" << std::endl;
+            }
+            csv << libreria << "," << n << "," << grupo << "," << hilos << "," << r.peticiones_por_s << "," << eficiencia
+                << "," << r.latencia.mediana << "," << r.latencia.p90 << "," << r.latencia.p99 << "," << r.peor_p99_hilo
+                << "\n";
+        }
+    }
+}
+
+} // namespace bench
@@ -1,4 +1,16 @@
+#pragma once
+
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define TOOLS_TSC 1
+#endif
 
 template <class T, size_t Align, class... Args>
 T* alloc_aligned(size_t n, Args&& ... args)
@@ -28,3 +40,168 @@ double get_time_us(T const& start, T const& end, uint32_t N)
   auto diff = end-start;
   return (long double)(std::chrono::duration<long double, std::micro>(diff).count())/static_cast<long double>(N);
 }
+
+// Temporizador de ciclos para operaciones de menos de un microsegundo, donde
+// la resolución y el coste de std::chrono ya pesan (la suma de polinomios en
+// NTT está en 0.06-0.13 us). En x86 con TSC invariante lee el contador con
+// lfence; rdtsc al empezar y rdtscp; lfence al terminar, para que las
+// instrucciones medidas no se adelanten ni se retrasen fuera de la medida.
+// La frecuencia del TSC se calibra una vez contra steady_clock y al resultado
+// se le resta el coste de la propia medida (el mínimo de muchas medidas
+// vacías). Sin TSC invariante se usa steady_clock, también descontando su
+// coste, y los ciclos quedan a 0.
+//
+//   cycle_timer t;
+//   t.start();
+//   ...
+//   timer_sample m = t.stop(); // m.cycles, m.ns
+//
+// Si hay trabajo que hacer entre el final de la medida y stop() (buscar qué
+// temporizador es, por ejemplo), se lee antes el reloj con
+// cycle_timer::mark() y se termina con stop(marca).
+
+struct timer_sample {
+	uint64_t cycles; // 0 si no hay TSC
+	double ns;
+};
+
+// Lectura del reloj (ciclos del TSC o steady_clock, según la calibración)
+struct timer_mark {
+	uint64_t cycles;
+	std::chrono::steady_clock::time_point time;
+};
+
+struct tsc_calibration {
+	bool tsc;                 // Se usa el TSC (si no, steady_clock)
+	double cycles_per_ns;     // Frecuencia del TSC en GHz
+	uint64_t overhead_cycles; // Coste de una medida vacía con el TSC
+	double overhead_ns;       // Coste de una medida vacía en ns
+};
+
+#ifdef TOOLS_TSC
+inline uint64_t tsc_start()
+{
+	_mm_lfence();
+	uint64_t t = __rdtsc();
+	_mm_lfence();
+	return t;
+}
+
+inline uint64_t tsc_stop()
+{
+	unsigned int aux;
+	uint64_t t = __rdtscp(&aux);
+	_mm_lfence();
+	return t;
+}
+
+// TSC invariante: frecuencia constante y sigue contando en los estados de reposo
+inline bool tsc_invariant()
+{
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+		return false;
+	}
+	// rdtscp: bit 27 de edx en 0x80000001; TSC invariante: bit 8 de edx en 0x80000007
+	__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+	bool rdtscp = (edx & (1u << 27)) != 0;
+	edx = 0;
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+	return rdtscp && (edx & (1u << 8)) != 0;
+}
+#endif
+
+// Calibración (se hace la primera vez que se llama, unos 30 ms)
+inline tsc_calibration const& get_tsc_calibration()
+{
+	static tsc_calibration const calibration = [] {
+		tsc_calibration c = {false, 0, 0, 0};
+		int const vacias = 1000; // Medidas vacías para estimar el coste
+		typedef std::chrono::steady_clock reloj;
+#ifdef TOOLS_TSC
+		if (tsc_invariant()) {
+			// Tres medidas de 10 ms contra steady_clock, nos quedamos con la mediana
+			double frecuencias[3];
+			for (double& f : frecuencias) {
+				reloj::time_point t0 = reloj::now();
+				uint64_t c0 = tsc_start();
+				while (reloj::now() - t0 < std::chrono::milliseconds(10)) {
+				}
+				uint64_t c1 = tsc_stop();
+				reloj::time_point t1 = reloj::now();
+				f = (c1 - c0) / std::chrono::duration<double, std::nano>(t1 - t0).count();
+			}
+			std::sort(frecuencias, frecuencias + 3);
+			c.tsc = true;
+			c.cycles_per_ns = frecuencias[1];
+			c.overhead_cycles = UINT64_MAX;
+			for (int i = 0; i < vacias; i++) {
+				uint64_t c0 = tsc_start();
+				uint64_t c1 = tsc_stop();
+				c.overhead_cycles = std::min(c.overhead_cycles, c1 - c0);
+			}
+			c.overhead_ns = c.overhead_cycles / c.cycles_per_ns;
+			return c;
+		}
+#endif
+		c.overhead_ns = 1e300;
+		for (int i = 0; i < vacias; i++) {
+			reloj::time_point t0 = reloj::now();
+			reloj::time_point t1 = reloj::now();
+			c.overhead_ns = std::min(c.overhead_ns, std::chrono::duration<double, std::nano>(t1 - t0).count());
+		}
+		return c;
+	}();
+	return calibration;
+}
+
+class cycle_timer {
+public:
+	cycle_timer() : calibration_(get_tsc_calibration()) {}
+
+	void start()
+	{
+#ifdef TOOLS_TSC
+		if (calibration_.tsc) {
+			start_cycles_ = tsc_start();
+			return;
+		}
+#endif
+		start_time_ = std::chrono::steady_clock::now();
+	}
+
+	// Lectura del reloj para terminar una medida con stop(marca)
+	static timer_mark mark()
+	{
+#ifdef TOOLS_TSC
+		if (get_tsc_calibration().tsc) {
+			return {tsc_stop(), std::chrono::steady_clock::time_point()};
+		}
+#endif
+		return {0, std::chrono::steady_clock::now()};
+	}
+
+	// Tiempo desde start() sin el coste de la medida
+	timer_sample stop() { return stop(mark()); }
+
+	// Tiempo desde start() hasta la marca
+	timer_sample stop(timer_mark const& end_mark)
+	{
+#ifdef TOOLS_TSC
+		if (calibration_.tsc) {
+			uint64_t cycles = end_mark.cycles - start_cycles_;
+			cycles = cycles > calibration_.overhead_cycles ? cycles - calibration_.overhead_cycles : 0;
+			return {cycles, cycles / calibration_.cycles_per_ns};
+		}
+#endif
+		double ns = std::chrono::duration<double, std::nano>(end_mark.time - start_time_).count() - calibration_.overhead_ns;
+		return {0, ns > 0 ? ns : 0};
+	}
+
+	tsc_calibration const& calibration() const { return calibration_; }
+
+private:
+	tsc_calibration const& calibration_;
+	uint64_t start_cycles_ = 0;
+	std::chrono::steady_clock::time_point start_time_;
+};
@@ -22,14 +22,24 @@
 
 #pragma once
 
+#include <sys/mman.h>
+#include <climits>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 
 #include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <new>
+#include <vector>
 #include <nfl.hpp>
 
+#include "FV_noise.hpp"
+#include "FV_pool.hpp"
+#include "FV_prng.hpp"
+
 namespace FV {
 
 // Parameters (need to be defined before inclusion)
@@ -41,6 +51,12 @@ namespace FV {
 // @param fg_prng_evk (FastGaussianNoise)
 // @param fg_prng_pk (FastGaussianNoise)
 // @param fg_prng_enc (FastGaussianNoise)
+// @param word_size (size_t) bits per word of the evaluation key decomposition;
+//        FV.hpp does not read it: callers pass it to evk_t, usually as
+//        params::word_size, so it may be a variable
+//
+// The samplers can also be util::shared_noise (see FV_noise.hpp): built on
+// first use, each with its own stream over a shared table.
 //
 namespace params {
 using poly_p =
@@ -53,6 +69,9 @@ class sk_t;
 class pk_t;
 class evk_t;
 class ciphertext_t;
+class ciphertext_view;
+class tensor_ciphertext_t;
+class seeded_ciphertext_t;
 template <typename T>
 class message_t;
 using mess_t = message_t<mpz_class>;
@@ -77,11 +96,205 @@ inline void lift(std::array<mpz_t, params::polyZ_p::degree> &coefficients,
                  params::polyZ_p const &c);
 void convert(params::polyZ_p &new_c, params::poly_p const &c,
              bool ntt_form = true);
+void convert(params::polyZ_p &new_c,
+             typename params::poly_p::value_type const *c,
+             bool ntt_form = true);
 template <typename T>
 T message_from_mpz_t(mpz_t value);
 }  // namespace util
 }  // namespace FV
 
+/**
+ * Modular arithmetic on raw residues and aligned storage for key material
+ */
+namespace FV {
+namespace util {
+template <typename T>
+struct greater_value_type;
+template <>
+struct greater_value_type<uint16_t> {
+  using type = uint32_t;
+};
+template <>
+struct greater_value_type<uint32_t> {
+  using type = uint64_t;
+};
+template <>
+struct greater_value_type<uint64_t> {
+  using type = __uint128_t;
+};
+
+/**
+ * Precompute the Shoup representation floor(y * 2^nbits / p) of y
+ * @param y value already reduced modulo p
+ * @param p modulus
+ */
+template <typename T>
+inline T shoup_precompute(T y, T p) {
+  using W = typename greater_value_type<T>::type;
+  return static_cast<T>((static_cast<W>(y) << (sizeof(T) * CHAR_BIT)) / p);
+}
+
+/**
+ * Compute x*y mod p using the Shoup representation yprime of y
+ * @param x      multiplicand
+ * @param y      multiplier already reduced modulo p
+ * @param yprime shoup_precompute(y, p)
+ * @param p      modulus
+ */
+template <typename T>
+inline T mulmod_shoup(T x, T y, T yprime, T p) {
+  using W = typename greater_value_type<T>::type;
+  T q = static_cast<T>((static_cast<W>(x) * yprime) >> (sizeof(T) * CHAR_BIT));
+  T r = x * y - q * p;
+  return r >= p ? r - p : r;
+}
+
+/**
+ * Compute x*y mod p without precomputation
+ */
+template <typename T>
+inline T mulmod(T x, T y, T p) {
+  using W = typename greater_value_type<T>::type;
+  return static_cast<T>((static_cast<W>(x) * y) % p);
+}
+
+/**
+ * RAII buffer aligned on a cache line, optionally backed by huge pages
+ */
+template <typename T>
+class aligned_buffer {
+ public:
+  static constexpr size_t alignment = 64;
+  static constexpr size_t huge_page_size = 1 << 21;
+
+  aligned_buffer() = default;
+  aligned_buffer(size_t n, bool huge_pages = false) { allocate(n, huge_pages); }
+  aligned_buffer(aligned_buffer const &) = delete;
+  aligned_buffer &operator=(aligned_buffer const &) = delete;
+  aligned_buffer(aligned_buffer &&other) noexcept { swap(other); }
+  aligned_buffer &operator=(aligned_buffer &&other) noexcept {
+    release();
+    swap(other);
+    return *this;
+  }
+  ~aligned_buffer() { release(); }
+
+  /// Allocate n elements (previous content is released)
+  void allocate(size_t n, bool huge_pages = false) {
+    release();
+    size_t bytes = n * sizeof(T);
+    if (bytes == 0) {
+      return;
+    }
+    if (huge_pages) {
+      // Explicit huge pages first, then transparent huge pages
+      size_t rounded = (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+      void *p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p == MAP_FAILED) {
+        p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+        if (p != MAP_FAILED) {
+          madvise(p, rounded, MADV_HUGEPAGE);
+        }
+#endif
+      }
+      if (p != MAP_FAILED) {
+        _base = p;
+        _data = static_cast<T *>(p);
+        _size = n;
+        _mapped_bytes = rounded;
+        return;
+      }
+    }
+    void *p;
+    if (posix_memalign(&p, alignment, bytes) != 0) {
+      throw std::bad_alloc();
+    }
+    _base = p;
+    _data = static_cast<T *>(p);
+    _size = n;
+  }
+
+  /**
+   * Take ownership of n elements stored at byte "offset" of an existing
+   * mapping (e.g. a file mapped with mmap); the mapping is unmapped on release
+   * @param base         start of the mapping
+   * @param mapped_bytes length of the mapping
+   * @param offset       offset of the first element, multiple of alignment
+   * @param n            number of elements
+   */
+  static aligned_buffer adopt_mapping(void *base, size_t mapped_bytes,
+                                      size_t offset, size_t n) {
+    aligned_buffer buffer;
+    buffer._base = base;
+    buffer._data =
+        reinterpret_cast<T *>(static_cast<unsigned char *>(base) + offset);
+    buffer._size = n;
+    buffer._mapped_bytes = mapped_bytes;
+    return buffer;
+  }
+
+  inline T *data() { return _data; }
+  inline T const *data() const { return _data; }
+  inline size_t size() const { return _size; }
+  inline bool mapped() const { return _mapped_bytes != 0; }
+
+ private:
+  void *_base = nullptr;  // start of the allocation or of the mapping
+  T *_data = nullptr;
+  size_t _size = 0;
+  size_t _mapped_bytes = 0;  // != 0 when the buffer comes from mmap
+
+  void swap(aligned_buffer &other) {
+    std::swap(_base, other._base);
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_mapped_bytes, other._mapped_bytes);
+  }
+  void release() {
+    if (_base != nullptr) {
+      if (_mapped_bytes != 0) {
+        munmap(_base, _mapped_bytes);
+      } else {
+        free(_base);
+      }
+    }
+    _base = nullptr;
+    _data = nullptr;
+    _size = 0;
+    _mapped_bytes = 0;
+  }
+};
+}  // namespace util
+}  // namespace FV
+
+/**
+ * Noise from one of the process-wide samplers of params (fg_prng_*), with the
+ * fill(P&) interface of prng::cdt_gaussian. Not thread-safe: concurrent code
+ * uses the samplers of a context_t (FV_context.hpp).
+ */
+namespace FV {
+namespace util {
+template <class G>
+struct global_noise_t {
+  G *prng;
+  void fill(params::poly_p &p) { p = params::gauss_struct(prng); }
+};
+template <>
+struct global_noise_t<shared_noise> {
+  shared_noise *prng;
+  void fill(params::poly_p &p) { prng->fill(p); }
+};
+template <class G>
+global_noise_t<G> global_noise(G *prng) {
+  return global_noise_t<G>{prng};
+}
+}  // namespace util
+}  // namespace FV
+
 /**
  * Class to store the secret key
  */
@@ -91,14 +304,62 @@ class sk_t {
 
  public:
   /// The secret key is a polynomial
-  P value{params::gauss_struct(&params::fg_prng_sk)};
+  P value;
   P value_shoup;
 
   /// Constructor
   sk_t() {
+    util::global_noise(&params::fg_prng_sk).fill(value);
     value.ntt_pow_phi();  // store in NTT form
     value_shoup = nfl::compute_shoup(value);
   }
+
+  /// Constructor drawing the key from a given sampler
+  explicit sk_t(prng::cdt_gaussian &noise) : value(sample(noise)) {
+    value.ntt_pow_phi();
+    value_shoup = nfl::compute_shoup(value);
+  }
+
+  /// Constructor from a stored key (both polynomials in NTT form)
+  sk_t(P const &value_in, P const &value_shoup_in)
+      : value(value_in), value_shoup(value_shoup_in) {}
+
+ private:
+  static P sample(prng::cdt_gaussian &noise) {
+    P p;
+    noise.fill(p);
+    return p;
+  }
+};
+}  // namespace FV
+
+/**
+ * How an evaluation key is generated and stored, set by name:
+ *
+ *   evk_t evk(sk, word_size, evk_options().threads(pool).compact());
+ */
+namespace FV {
+struct evk_options {
+  /// Back the key material with huge pages if possible
+  bool huge_pages = false;
+  /// Store values[i][1] (twice the memory, faster products)
+  bool expanded = true;
+  /// Threads for the key pairs (serial when null)
+  util::thread_pool *pool = nullptr;
+
+  evk_options &with_huge_pages(bool on = true) {
+    huge_pages = on;
+    return *this;
+  }
+  /// Regenerate values[i][1] from the seed instead of storing it
+  evk_options &compact() {
+    expanded = false;
+    return *this;
+  }
+  evk_options &threads(util::thread_pool &workers) {
+    pool = &workers;
+    return *this;
+  }
 };
 }  // namespace FV
 
@@ -110,20 +371,162 @@ class evk_t {
   using P = params::poly_p;
 
  public:
+  typedef typename P::value_type value_type;
+
+  /// Number of residues in one polynomial
+  static constexpr size_t poly_size = P::degree * P::nmoduli;
+  /// Number of residues of one key pair (value and Shoup data of both halves)
+  static constexpr size_t pair_size = 4 * poly_size;
+  /// Number of residues of one key pair when values[i][1] is not stored
+  static constexpr size_t compact_pair_size = 2 * poly_size;
+
   size_t ell;  // log_2(q)+1
   size_t word_size;
   mpz_t word;
   mpz_t word_mask;
-  P **values;
-  P **values_shoup;
+  /// Key material in one contiguous block, in the order read by the
+  /// relinearization: for each i, [values[i][0] | shoup | values[i][1] | shoup]
+  /// or only [values[i][0] | shoup] when the key is not expanded
+  util::aligned_buffer<value_type> values;
+  /// Seed of the uniform halves: values[i][1] is stream i of the seed
+  prng::seed_t seed;
+  /// false when values[i][1] is regenerated from the seed on the fly
+  bool expanded;
   mpz_t qDivBy2;
   mpz_t bigmodDivBy2;
 
-  /// Constructor
-  evk_t(sk_t const &sk, size_t word_size) : word_size(word_size) {
+  /**
+   * Constructor
+   * @param sk        secret key
+   * @param word_size size in bits of the decomposition words
+   * @param options   huge pages, layout and threads (see evk_options)
+   */
+  evk_t(sk_t const &sk, size_t word_size,
+        evk_options const &options = evk_options())
+      : word_size(word_size),
+        seed(prng::fresh_seed()),
+        expanded(options.expanded) {
+    auto noise = util::global_noise(&params::fg_prng_evk);
+    generate(sk, noise, options.huge_pages, options.pool);
+  }
+
+  /**
+   * Constructor drawing the key from a given sampler and seed
+   * @param noise sampler of the small polynomials
+   * @param seed  seed of the uniform halves
+   */
+  evk_t(sk_t const &sk, size_t word_size, prng::cdt_gaussian &noise,
+        prng::seed_t const &seed, evk_options const &options = evk_options())
+      : word_size(word_size), seed(seed), expanded(options.expanded) {
+    generate(sk, noise, options.huge_pages, options.pool);
+  }
+
+  /// Constructor from stored key material (e.g. a mapped file)
+  evk_t(size_t word_size, prng::seed_t const &seed, bool expanded,
+        util::aligned_buffer<value_type> &&values_in)
+      : word_size(word_size),
+        values(std::move(values_in)),
+        seed(seed),
+        expanded(expanded) {
+    init();
+    assert(values.size() == ell * pair_stride());
+  }
+
+
+  evk_t(evk_t const &) = delete;
+  evk_t &operator=(evk_t const &) = delete;
+
+  /// Destructor
+  ~evk_t() { mpz_clears(qDivBy2, bigmodDivBy2, word, word_mask, nullptr); }
+
+  /// Number of key pairs for a given word size
+  static size_t ell_for(size_t word_size) {
+    return floor(mpz_sizeinbase(P::moduli_product(), 2) / word_size) + 1;
+  }
+
+  /// Number of residues between two consecutive key pairs
+  inline size_t pair_stride() const {
+    return expanded ? pair_size : compact_pair_size;
+  }
+
+  /// Start of the i-th key pair in the flat block
+  inline value_type *pair(size_t i) { return values.data() + i * pair_stride(); }
+  inline value_type const *pair(size_t i) const {
+    return values.data() + i * pair_stride();
+  }
+
+  /**
+   * Copy values[i][0] into the flat block and, if the key is expanded,
+   * regenerate values[i][1] from the seed; compute the Shoup data of both
+   */
+  void store(size_t i, P const &value0) {
+    value_type *dst = pair(i);
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      value_type const p = P::get_modulus(cm);
+      value_type *v0 = dst + cm * P::degree;
+      value_type *v0_shoup = v0 + poly_size;
+      for (size_t k = 0; k < P::degree; k++) {
+        v0[k] = value0(cm, k);
+        v0_shoup[k] = util::shoup_precompute(v0[k], p);
+      }
+    }
+    if (expanded) {
+      expand_pair(i, dst);
+    }
+  }
+
+  /**
+   * Switch a compact key to the expanded layout, regenerating every
+   * values[i][1] once (e.g. after loading a compact key from disk)
+   */
+  void expand(bool huge_pages = false) {
+    if (expanded) {
+      return;
+    }
+    util::aligned_buffer<value_type> full(ell * pair_size, huge_pages);
+    for (size_t i = 0; i < ell; i++) {
+      value_type *dst = full.data() + i * pair_size;
+      std::copy(pair(i), pair(i) + compact_pair_size, dst);
+      expand_pair(i, dst);
+    }
+    values = std::move(full);
+    expanded = true;
+  }
+
+  /**
+   * Accumulate the i-th key pair: c0 += c2i * values[i][0] and
+   * c1 += c2i * values[i][1] (everything in NTT form)
+   */
+  void accumulate(P &c0, P &c1, P const &c2i, size_t i) const {
+    if (!expanded) {
+      accumulate_on_the_fly(c0, c1, c2i, i);
+      return;
+    }
+    value_type const *src = pair(i);
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      value_type const p = P::get_modulus(cm);
+      value_type const *v0 = src + cm * P::degree;
+      value_type const *v0_shoup = v0 + poly_size;
+      value_type const *v1 = v0_shoup + poly_size;
+      value_type const *v1_shoup = v1 + poly_size;
+      value_type const *x = &c2i(cm, 0);
+      value_type *r0 = &c0(cm, 0);
+      value_type *r1 = &c1(cm, 0);
+      for (size_t k = 0; k < P::degree; k++) {
+        value_type t0 = r0[k] + util::mulmod_shoup(x[k], v0[k], v0_shoup[k], p);
+        value_type t1 = r1[k] + util::mulmod_shoup(x[k], v1[k], v1_shoup[k], p);
+        r0[k] = t0 >= p ? t0 - p : t0;
+        r1[k] = t1 >= p ? t1 - p : t1;
+      }
+    }
+  }
+
+ private:
+  /// Initialize ell and the constants derived from the moduli and word size
+  void init() {
     mpz_inits(qDivBy2, bigmodDivBy2, word, word_mask, nullptr);
 
-    ell = floor(mpz_sizeinbase(P::moduli_product(), 2) / word_size) + 1;
+    ell = ell_for(word_size);
 
     mpz_fdiv_q_ui(qDivBy2, P::moduli_product(), 2);
     mpz_fdiv_q_ui(bigmodDivBy2, params::polyZ_p::moduli_product(), 2);
@@ -132,48 +535,104 @@ class evk_t {
     mpz_set_ui(word, 1);
     mpz_mul_2exp(word, word, word_size);
     mpz_sub_ui(word_mask, word, 1);
+  }
 
-    // Temporary values that will contain word^i
-    mpz_t tmp_word;
-    mpz_init_set_ui(tmp_word, 1);
-    P add;
+  /**
+   * Draw the key pairs, with the small polynomials taken from noise
+   * The noise is drawn serially, in the order of i, into the values[i][0]
+   * slots, so the key does not depend on the pool; the rest of every pair only
+   * depends on i and runs on the pool (serially without one).
+   */
+  template <class N>
+  void generate(sk_t const &sk, N &noise, bool huge_pages,
+                util::thread_pool *pool) {
+    init();
 
     // Allocate values
-    values = (P **)malloc(ell * sizeof(P *));
-    values_shoup = (P **)malloc(ell * sizeof(P *));
+    values.allocate(ell * pair_stride(), huge_pages);
+    P e;
     for (size_t i = 0; i < ell; ++i) {
-      values[i] = new P[2];
-      values[i][1] = nfl::uniform();
-      values[i][0] = params::gauss_struct(&params::fg_prng_evk);
-      values[i][0].ntt_pow_phi();
-      values[i][0] = values[i][0] - values[i][1] * sk.value;
-
-      add = tmp_word;
-      add.ntt_pow_phi();
-      add = add * sk.value * sk.value;
-      values[i][0] = values[i][0] + add;
-
-      values_shoup[i] = new P[2];
-      values_shoup[i][1] = nfl::compute_shoup(values[i][1]);
-      values_shoup[i][0] = nfl::compute_shoup(values[i][0]);
-
-      // Update for next loop
-      mpz_mul_2exp(tmp_word, tmp_word, word_size);
+      noise.fill(e);
+      value_type *dst = pair(i);
+      for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        std::copy(&e(cm, 0), &e(cm, 0) + P::degree, dst + cm * P::degree);
+      }
+    }
+
+    // word^i mod each modulus: word^i * s^2 is a scalar times s^2 in NTT form
+    std::vector<value_type> word_pow(ell * P::nmoduli);
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      value_type const p = P::get_modulus(cm);
+      value_type const word_mod = static_cast<value_type>(
+          mpz_fdiv_ui(word, static_cast<unsigned long>(p)));
+      value_type w = 1;
+      for (size_t i = 0; i < ell; ++i) {
+        word_pow[i * P::nmoduli + cm] = w;
+        w = util::mulmod(w, word_mod, p);
+      }
     }
+    P const s2 = sk.value * sk.value;
+
+    util::thread_pool serial(1);
+    util::thread_pool &workers = pool ? *pool : serial;
+    std::vector<P> value0(workers.size()), value1(workers.size());
+    workers.parallel_for(ell, [&](size_t worker, size_t i) {
+      P &v0 = value0[worker];
+      P &v1 = value1[worker];
+      value_type const *src = pair(i);
+      for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        std::copy(src + cm * P::degree, src + (cm + 1) * P::degree, &v0(cm, 0));
+      }
+      prng::uniform_poly(v1, seed, i);
+      v0.ntt_pow_phi();
+      v0 = v0 - v1 * sk.value;
+
+      for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        value_type const p = P::get_modulus(cm);
+        value_type const w = word_pow[i * P::nmoduli + cm];
+        value_type const w_shoup = util::shoup_precompute(w, p);
+        for (size_t k = 0; k < P::degree; k++) {
+          value_type t = v0(cm, k) + util::mulmod_shoup(s2(cm, k), w, w_shoup, p);
+          v0(cm, k) = t >= p ? t - p : t;
+        }
+      }
 
-    // Clean
-    mpz_clear(tmp_word);
+      store(i, v0);
+    });
   }
 
-  /// Destructor
-  ~evk_t() {
-    mpz_clears(qDivBy2, bigmodDivBy2, word, word_mask, nullptr);
-    for (size_t i = 0; i < ell; i++) {
-      delete[] values[i];
-      delete[] values_shoup[i];
+  /// Write values[i][1] and its Shoup data after values[i][0] in dst
+  void expand_pair(size_t i, value_type *dst) const {
+    prng::uniform_residues<P> rng(seed, i);
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      value_type const p = P::get_modulus(cm);
+      value_type *v1 = dst + 2 * poly_size + cm * P::degree;
+      value_type *v1_shoup = v1 + poly_size;
+      rng.fill(cm, v1, P::degree);
+      for (size_t k = 0; k < P::degree; k++) {
+        v1_shoup[k] = util::shoup_precompute(v1[k], p);
+      }
+    }
+  }
+
+  /// accumulate() for a compact key: values[i][1] comes from the seed
+  void accumulate_on_the_fly(P &c0, P &c1, P const &c2i, size_t i) const {
+    prng::uniform_residues<P> rng(seed, i);
+    value_type const *src = pair(i);
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      value_type const p = P::get_modulus(cm);
+      value_type const *v0 = src + cm * P::degree;
+      value_type const *v0_shoup = v0 + poly_size;
+      value_type const *x = &c2i(cm, 0);
+      value_type *r0 = &c0(cm, 0);
+      value_type *r1 = &c1(cm, 0);
+      for (size_t k = 0; k < P::degree; k++) {
+        value_type t0 = r0[k] + util::mulmod_shoup(x[k], v0[k], v0_shoup[k], p);
+        value_type t1 = r1[k] + util::mulmod(x[k], rng.next(cm), p);
+        r0[k] = t0 >= p ? t0 - p : t0;
+        r1[k] = t1 >= p ? t1 - p : t1;
+      }
     }
-    free(values);
-    free(values_shoup);
   }
 };
 }  // namespace FV
@@ -190,6 +649,9 @@ class pk_t {
   P a, b, delta;
   P a_shoup, b_shoup, delta_shoup;
 
+  /// Seed the uniform polynomial a is expanded from
+  prng::seed_t seed;
+
   /// Link to evaluation key
   evk_t *evk;
 
@@ -197,20 +659,54 @@ class pk_t {
   long noise_max;
 
   /// Constructor
-  pk_t(sk_t const &sk, evk_t const &evaluation_key) {
+  pk_t(sk_t const &sk, evk_t const &evaluation_key)
+      : seed(prng::fresh_seed()) {
+    auto noise = util::global_noise(&params::fg_prng_pk);
+    generate(sk, evaluation_key, noise);
+  }
+
+  /**
+   * Constructor drawing the key from a given sampler and seed
+   * @param noise sampler of the small polynomial
+   * @param seed  seed of a
+   */
+  pk_t(sk_t const &sk, evk_t const &evaluation_key, prng::cdt_gaussian &noise,
+       prng::seed_t const &seed_in)
+      : seed(seed_in) {
+    generate(sk, evaluation_key, noise);
+  }
+
+  /// Constructor from a stored key (seed of a, b and its Shoup data)
+  pk_t(evk_t const &evaluation_key, prng::seed_t const &seed_in,
+       P const &b_in, P const &b_shoup_in)
+      : b(b_in), b_shoup(b_shoup_in), seed(seed_in) {
+    evk = (evk_t *)&evaluation_key;
+    prng::uniform_poly(a, seed);
+    a_shoup = nfl::compute_shoup(a);
+    init();
+  }
+
+ private:
+  template <class N>
+  void generate(sk_t const &sk, evk_t const &evaluation_key, N &noise) {
     // Link to the evaluation key
     evk = (evk_t *)&evaluation_key;
 
-    // random a (already in NTT form)
-    a = nfl::uniform();
+    // random a (already in NTT form), expanded from the seed
+    prng::uniform_poly(a, seed);
     a_shoup = nfl::compute_shoup(a);
 
     // b = small - a*sk
-    b = params::gauss_struct(&params::fg_prng_pk);
+    noise.fill(b);
     b.ntt_pow_phi();  // transform via NTT
     b = b - a * sk.value;
     b_shoup = nfl::compute_shoup(b);
 
+    init();
+  }
+
+  /// Compute noise_max and delta, which only depend on the parameters
+  void init() {
     // Set the plaintext modulus
     noise_max =
         mpz_sizeinbase(P::moduli_product(), 2) - 1 -
@@ -229,6 +725,185 @@ class pk_t {
 };
 }  // namespace FV
 
+/**
+ * Arithmetic on polynomials given either as poly_p or as raw residue arrays
+ * (nmoduli arrays of degree residues, in NTT form)
+ */
+namespace FV {
+namespace util {
+inline typename params::poly_p::value_type const *residues(
+    params::poly_p const &p, size_t cm) {
+  return &p(cm, 0);
+}
+inline typename params::poly_p::value_type const *residues(
+    typename params::poly_p::value_type const *p, size_t cm) {
+  return p + cm * params::poly_p::degree;
+}
+
+/// c = a + b
+template <class A, class B>
+void add(params::poly_p &c, A const &a, B const &b) {
+  using P = params::poly_p;
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    typename P::value_type const p = P::get_modulus(cm);
+    typename P::value_type const *x = residues(a, cm);
+    typename P::value_type const *y = residues(b, cm);
+    for (size_t k = 0; k < P::degree; k++) {
+      typename P::value_type r = x[k] + y[k];
+      c(cm, k) = r >= p ? r - p : r;
+    }
+  }
+}
+
+/// c = a - b
+template <class A, class B>
+void sub(params::poly_p &c, A const &a, B const &b) {
+  using P = params::poly_p;
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    typename P::value_type const p = P::get_modulus(cm);
+    typename P::value_type const *x = residues(a, cm);
+    typename P::value_type const *y = residues(b, cm);
+    for (size_t k = 0; k < P::degree; k++) {
+      c(cm, k) = x[k] >= y[k] ? x[k] - y[k] : x[k] + (p - y[k]);
+    }
+  }
+}
+}  // namespace util
+}  // namespace FV
+
+/**
+ * Product of two ciphertexts (a0, a1) and (b0, b1): tensor product over ZZ
+ * and scaling by t/q into (c0, c1, c2), with c0 and c1 in NTT form and c2 as
+ * integer coefficients (c2 is initialized by the caller). The operands are
+ * polynomials or raw residue arrays (see ciphertext_view) and may alias c0
+ * and c1.
+ */
+namespace FV {
+namespace util {
+template <class A, class B>
+void tensor(params::poly_p &c0, params::poly_p &c1,
+            std::array<mpz_t, params::poly_p::degree> &c2, A const &a0,
+            A const &a1, B const &b0, B const &b1, pk_t const &pk) {
+  using P = params::poly_p;
+  using PZ = params::polyZ_p;
+
+  // Allocations
+  PZ c00, c10, c01, c11, c1b;
+
+  // View the polynomials as PZ polynomials
+  convert(c00, a0);
+  convert(c01, a1);
+  convert(c10, b0);
+  convert(c11, b1);
+
+  // Compute products "over ZZ"
+  c1b = c00 * c11 + c01 * c10;
+  c00 = c00 * c10;
+  c11 = c01 * c11;
+
+  // Multiply by 2/q
+  lift(c2, c00);
+  reduce<PZ::degree>(
+      c2, params::plaintextModulus<mpz_class>::value().get_mpz_t(),
+      P::moduli_product(), pk.evk->qDivBy2, PZ::moduli_product(),
+      pk.evk->bigmodDivBy2);
+  c0.mpz2poly(c2);
+  c0.ntt_pow_phi();
+
+  lift(c2, c1b);
+  reduce<PZ::degree>(
+      c2, params::plaintextModulus<mpz_class>::value().get_mpz_t(),
+      P::moduli_product(), pk.evk->qDivBy2, PZ::moduli_product(),
+      pk.evk->bigmodDivBy2);
+  c1.mpz2poly(c2);
+  c1.ntt_pow_phi();
+
+  lift(c2, c11);
+  reduce<PZ::degree>(
+      c2, params::plaintextModulus<mpz_class>::value().get_mpz_t(),
+      P::moduli_product(), pk.evk->qDivBy2, PZ::moduli_product(),
+      pk.evk->bigmodDivBy2);
+}
+
+/**
+ * Relinearization: add the decomposition of c2 (integer coefficients,
+ * overwritten) times the evaluation key to (c0, c1)
+ */
+inline void relinearize(params::poly_p &c0, params::poly_p &c1,
+                        std::array<mpz_t, params::poly_p::degree> &c2,
+                        evk_t const &evk) {
+  using P = params::poly_p;
+
+  // Decompose c2i and multiply by evaluation keys
+  P c2i;
+
+  std::array<mpz_t, P::degree> decomp;
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_init2(decomp[i], evk.word_size);
+    mpz_mod(c2[i], c2[i], P::moduli_product());
+  }
+
+  for (size_t i = 0; i < evk.ell; i++) {
+    for (size_t k = 0; k < P::degree; k++) {
+      mpz_and(decomp[k], c2[k], evk.word_mask);
+      mpz_fdiv_q_2exp(c2[k], c2[k], evk.word_size);
+    }
+    c2i.mpz2poly(decomp);
+    c2i.ntt_pow_phi();
+    evk.accumulate(c0, c1, c2i, i);
+  }
+
+  // Clean
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_clear(decomp[i]);
+  }
+}
+
+/**
+ * Product of two ciphertexts (a0, a1) and (b0, b1) into (c0, c1): tensor
+ * product then relinearization with the evaluation key of pk
+ */
+template <class A, class B>
+void multiply(params::poly_p &c0, params::poly_p &c1, A const &a0, A const &a1,
+              B const &b0, B const &b1, pk_t const &pk) {
+  using P = params::poly_p;
+
+  std::array<mpz_t, P::degree> coefficients;
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_init2(coefficients[i], (P::bits_in_moduli_product() << 2));
+  }
+
+  tensor(c0, c1, coefficients, a0, a1, b0, b1, pk);
+  relinearize(c0, c1, coefficients, *pk.evk);
+
+  // Clean
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_clear(coefficients[i]);
+  }
+}
+}  // namespace util
+}  // namespace FV
+
+/**
+ * Ciphertext whose c0 and c1 are raw residue arrays owned elsewhere (e.g. a
+ * mapped batch file, see FV_io.hpp). It can be an operand of +, - and *
+ * (with ciphertext_t or another view); the residues are read in place.
+ */
+namespace FV {
+class ciphertext_view {
+ public:
+  using value_type = typename params::poly_p::value_type;
+
+  value_type const *c0;
+  value_type const *c1;
+  /// Link to public key
+  pk_t *pk;
+
+  ciphertext_view(value_type const *c0, value_type const *c1, pk_t *pk)
+      : c0(c0), c1(c1), pk(pk) {}
+};
+}  // namespace FV
+
 /**
  * Class to store a ciphertext
  */
@@ -286,6 +961,16 @@ class ciphertext_t {
     }
   }
 
+  /// Copy of a view
+  explicit ciphertext_t(ciphertext_view const &v) : pk(v.pk), isnull(false) {
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      std::copy(util::residues(v.c0, cm), util::residues(v.c0, cm) + P::degree,
+                &c0(cm, 0));
+      std::copy(util::residues(v.c1, cm), util::residues(v.c1, cm) + P::degree,
+                &c1(cm, 0));
+    }
+  }
+
   /// Assignment
   inline ciphertext_t &operator=(ciphertext_t const &ct) {
     c0 = ct.c0;
@@ -355,6 +1040,40 @@ class ciphertext_t {
     return ct -= rhs;
   }
 
+  /// Additions/Substractions of views
+  inline ciphertext_t &operator+=(ciphertext_view const &v) {
+    util::add(c0, c0, v.c0);
+    util::add(c1, c1, v.c1);
+    isnull = false;
+    return *this;
+  }
+  inline ciphertext_t &operator-=(ciphertext_view const &v) {
+    util::sub(c0, c0, v.c0);
+    util::sub(c1, c1, v.c1);
+    isnull = false;
+    return *this;
+  }
+  friend ciphertext_t operator+(ciphertext_t const &lhs,
+                                ciphertext_view const &rhs) {
+    ciphertext_t ct(lhs);
+    return ct += rhs;
+  }
+  friend ciphertext_t operator+(ciphertext_view const &lhs,
+                                ciphertext_t const &rhs) {
+    ciphertext_t ct(rhs);
+    return ct += lhs;
+  }
+  friend ciphertext_t operator-(ciphertext_t const &lhs,
+                                ciphertext_view const &rhs) {
+    ciphertext_t ct(lhs);
+    return ct -= rhs;
+  }
+  friend ciphertext_t operator-(ciphertext_view const &lhs,
+                                ciphertext_t const &rhs) {
+    ciphertext_t ct(lhs);
+    return ct -= rhs;
+  }
+
   inline ciphertext_t &operator+=(mpz_class const &value) {
     if (value == 0) {
       return *this;
@@ -465,86 +1184,37 @@ class ciphertext_t {
       isnull = true;
       return *this;
     }
+    util::multiply(c0, c1, c0, c1, ct.c0, ct.c1, *pk);
+    return *this;
+  }
+  friend ciphertext_t operator*(ciphertext_t const &lhs,
+                                ciphertext_t const &rhs) {
+    ciphertext_t ct(lhs);
+    return ct *= rhs;
+  }
 
-    size_t bits_in_moduli_product = P::bits_in_moduli_product();
-
-    // Allocations
-    PZ c00, c10, c01, c11, c1b;
-
-    // View the polynomials as PZ polynomials
-    util::convert(c00, c0);
-    util::convert(c01, c1);
-    util::convert(c10, ct.c0);
-    util::convert(c11, ct.c1);
-
-    // Compute products "over ZZ"
-    c1b = c00 * c11 + c01 * c10;
-    c00 = c00 * c10;
-    c11 = c01 * c11;
-
-    // Multiply by 2/q
-    std::array<mpz_t, P::degree> coefficients;
-    for (size_t i = 0; i < P::degree; i++) {
-      mpz_init2(coefficients[i], (bits_in_moduli_product << 2));
-    }
-
-    util::lift(coefficients, c00);
-    util::reduce<PZ::degree>(
-        coefficients, params::plaintextModulus<mpz_class>::value().get_mpz_t(),
-        P::moduli_product(), pk->evk->qDivBy2, PZ::moduli_product(),
-        pk->evk->bigmodDivBy2);
-    c0.mpz2poly(coefficients);
-    c0.ntt_pow_phi();
-
-    util::lift(coefficients, c1b);
-    util::reduce<PZ::degree>(
-        coefficients, params::plaintextModulus<mpz_class>::value().get_mpz_t(),
-        P::moduli_product(), pk->evk->qDivBy2, PZ::moduli_product(),
-        pk->evk->bigmodDivBy2);
-    c1.mpz2poly(coefficients);
-    c1.ntt_pow_phi();
-
-    util::lift(coefficients, c11);
-    util::reduce<PZ::degree>(
-        coefficients, params::plaintextModulus<mpz_class>::value().get_mpz_t(),
-        P::moduli_product(), pk->evk->qDivBy2, PZ::moduli_product(),
-        pk->evk->bigmodDivBy2);
-
-    // Decompose c2i and multiply by evaluation keys
-    P c2i;
-
-    std::array<mpz_t, P::degree> decomp;
-    for (size_t i = 0; i < P::degree; i++) {
-      mpz_init2(decomp[i], pk->evk->word_size);
-      mpz_mod(coefficients[i], coefficients[i], P::moduli_product());
-    }
-
-    for (size_t i = 0; i < pk->evk->ell; i++) {
-      for (size_t k = 0; k < P::degree; k++) {
-        mpz_and(decomp[k], coefficients[k], pk->evk->word_mask);
-        mpz_fdiv_q_2exp(coefficients[k], coefficients[k], pk->evk->word_size);
-      }
-      c2i.mpz2poly(decomp);
-      c2i.ntt_pow_phi();
-      c0 = c0 +
-           nfl::shoup(c2i * pk->evk->values[i][0], pk->evk->values_shoup[i][0]);
-      c1 = c1 +
-           nfl::shoup(c2i * pk->evk->values[i][1], pk->evk->values_shoup[i][1]);
-    }
-
-    // Clean
-    for (size_t i = 0; i < P::degree; i++) {
-      mpz_clear(decomp[i]);
-      mpz_clear(coefficients[i]);
+  /// Multiplication by a view
+  ciphertext_t &operator*=(ciphertext_view const &v) {
+    if (isnull == false) {
+      util::multiply(c0, c1, c0, c1, v.c0, v.c1, *pk);
     }
-
     return *this;
   }
   friend ciphertext_t operator*(ciphertext_t const &lhs,
-                                ciphertext_t const &rhs) {
+                                ciphertext_view const &rhs) {
     ciphertext_t ct(lhs);
     return ct *= rhs;
   }
+  friend ciphertext_t operator*(ciphertext_view const &lhs,
+                                ciphertext_t const &rhs) {
+    ciphertext_t ct;
+    ct.pk = lhs.pk;
+    if (rhs.isnull == false) {
+      util::multiply(ct.c0, ct.c1, lhs.c0, lhs.c1, rhs.c0, rhs.c1, *lhs.pk);
+      ct.isnull = false;
+    }
+    return ct;
+  }
 
   inline ciphertext_t &operator*=(mpz_class const &m) {
     if (m == 0) {
@@ -619,22 +1289,137 @@ class ciphertext_t {
 };
 }  // namespace FV
 
+/**
+ * Operations on two views
+ */
+namespace FV {
+inline ciphertext_t operator+(ciphertext_view const &lhs,
+                              ciphertext_view const &rhs) {
+  ciphertext_t ct;
+  ct.pk = lhs.pk;
+  ct.isnull = false;
+  util::add(ct.c0, lhs.c0, rhs.c0);
+  util::add(ct.c1, lhs.c1, rhs.c1);
+  return ct;
+}
+inline ciphertext_t operator-(ciphertext_view const &lhs,
+                              ciphertext_view const &rhs) {
+  ciphertext_t ct;
+  ct.pk = lhs.pk;
+  ct.isnull = false;
+  util::sub(ct.c0, lhs.c0, rhs.c0);
+  util::sub(ct.c1, lhs.c1, rhs.c1);
+  return ct;
+}
+inline ciphertext_t operator*(ciphertext_view const &lhs,
+                              ciphertext_view const &rhs) {
+  ciphertext_t ct;
+  ct.pk = lhs.pk;
+  ct.isnull = false;
+  util::multiply(ct.c0, ct.c1, lhs.c0, lhs.c1, rhs.c0, rhs.c1, *lhs.pk);
+  return ct;
+}
+}  // namespace FV
+
+/**
+ * Ciphertext of degree 2 (c0, c1, c2), the product of two ciphertexts before
+ * relinearization: a product is tensor() followed by relinearize(), which can
+ * be run separately (e.g. to relinearize once after adding several products)
+ */
+namespace FV {
+class tensor_ciphertext_t {
+  using P = params::poly_p;
+
+ public:
+  /// c0 and c1 in NTT form, c2 in coefficient form
+  P c0, c1, c2;
+
+  /// Link to public key
+  pk_t *pk = nullptr;
+
+  /// Boolean if the ciphertext is 0
+  bool isnull = true;
+
+  /// Addition of another product (same public key)
+  inline tensor_ciphertext_t &operator+=(tensor_ciphertext_t const &ct) {
+    if (ct.isnull == false) {
+      c0 = c0 + ct.c0;
+      c1 = c1 + ct.c1;
+      c2 = c2 + ct.c2;
+      pk = ct.pk;
+      isnull = false;
+    }
+    return *this;
+  }
+};
+
+/**
+ * Tensor product of two ciphertexts (without relinearization)
+ */
+inline tensor_ciphertext_t tensor(ciphertext_t const &lhs,
+                                  ciphertext_t const &rhs) {
+  using P = params::poly_p;
+  tensor_ciphertext_t ct;
+  ct.pk = lhs.pk;
+  if (lhs.isnull || rhs.isnull) {
+    ct.c0 = 0;
+    ct.c1 = 0;
+    ct.c2 = 0;
+    return ct;
+  }
+  std::array<mpz_t, P::degree> coefficients;
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_init2(coefficients[i], (P::bits_in_moduli_product() << 2));
+  }
+  util::tensor(ct.c0, ct.c1, coefficients, lhs.c0, lhs.c1, rhs.c0, rhs.c1,
+               *lhs.pk);
+  ct.c2.mpz2poly(coefficients);
+  ct.isnull = false;
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_clear(coefficients[i]);
+  }
+  return ct;
+}
+
+/**
+ * Relinearization of a tensor product back to a ciphertext (c0, c1)
+ */
+inline ciphertext_t relinearize(tensor_ciphertext_t const &ct) {
+  using P = params::poly_p;
+  ciphertext_t result;
+  result.pk = ct.pk;
+  if (ct.isnull) {
+    return result;
+  }
+  result.c0 = ct.c0;
+  result.c1 = ct.c1;
+  result.isnull = false;
+  std::array<mpz_t, P::degree> coefficients = ct.c2.poly2mpz();
+  util::relinearize(result.c0, result.c1, coefficients, *ct.pk->evk);
+  for (size_t i = 0; i < P::degree; i++) {
+    mpz_clear(coefficients[i]);
+  }
+  return result;
+}
+}  // namespace FV
+
 /**
  * Encrypt a polynomial poly_m
  * @param ct     ciphertext (passed by reference)
  * @param pk     public key
  * @param poly_m polynomial to encrypt
+ * @param noise  sampler filling a polynomial with small noise (fill(P&))
+ * @param u      scratch polynomial
  */
 namespace FV {
-template <class PK, class C>
-void encrypt_poly(C &ct, const PK &pk, params::poly_p &poly_m) {
-  using P = params::poly_p;
-
+template <class PK, class C, class N>
+void encrypt_poly(C &ct, const PK &pk, params::poly_p &poly_m, N &noise,
+                  params::poly_p &u) {
   // Apply the NTT on poly_m
   poly_m.ntt_pow_phi();
 
   // Generate a small u
-  P u{params::gauss_struct(&params::fg_prng_enc)};
+  noise.fill(u);
   u.ntt_pow_phi();
 
   // Set the ciphertext pk
@@ -642,18 +1427,100 @@ void encrypt_poly(C &ct, const PK &pk, params::poly_p &poly_m) {
 
   // Generate ct = (c0, c1)
   // where c0 = b*u + Delta*m + small error
-  ct.c0 = params::gauss_struct(&params::fg_prng_enc);
+  noise.fill(ct.c0);
   ct.c0.ntt_pow_phi();
   ct.c0 = ct.c0 + nfl::shoup(u * pk.b, pk.b_shoup) +
           nfl::shoup(poly_m * pk.delta, pk.delta_shoup);
 
   // where c1 = a*u + small error
-  ct.c1 = params::gauss_struct(&params::fg_prng_enc);
+  noise.fill(ct.c1);
   ct.c1.ntt_pow_phi();
   ct.c1 = ct.c1 + nfl::shoup(u * pk.a, pk.a_shoup);
 
   ct.isnull = false;
 }
+
+template <class PK, class C>
+void encrypt_poly(C &ct, const PK &pk, params::poly_p &poly_m) {
+  auto noise = util::global_noise(&params::fg_prng_enc);
+  params::poly_p u;
+  encrypt_poly(ct, pk, poly_m, noise, u);
+}
+}  // namespace FV
+
+/**
+ * Class to store a ciphertext produced with the secret key, whose c1 is a
+ * uniform polynomial stored as the seed it is expanded from
+ */
+namespace FV {
+class seeded_ciphertext_t {
+  using P = params::poly_p;
+
+ public:
+  /// c0 = -a*s + e + Delta*m, with a = c1 expanded from seed
+  P c0;
+  prng::seed_t seed;
+
+  /// Link to public key
+  pk_t *pk = nullptr;
+
+  /// Expand into a full ciphertext (c0, c1)
+  void expand(ciphertext_t &ct) const {
+    ct.c0 = c0;
+    prng::uniform_poly(ct.c1, seed);
+    ct.pk = pk;
+    ct.isnull = false;
+  }
+  ciphertext_t expand() const {
+    ciphertext_t ct;
+    expand(ct);
+    return ct;
+  }
+};
+}  // namespace FV
+
+/**
+ * Encrypt a polynomial poly_m with the secret key
+ * The ciphertext only keeps c0 and the seed of c1, and encryption costs one
+ * Gaussian sample and one product by the secret key
+ * @param ct     seeded ciphertext (passed by reference)
+ * @param sk     secret key
+ * @param pk     public key (for Delta and the link to the evaluation key)
+ * @param poly_m polynomial to encrypt
+ * @param noise  sampler of the error (fill(P&))
+ * @param seed   seed of c1
+ */
+namespace FV {
+template <class SK, class PK, class C, class N>
+void encrypt_poly_symmetric(C &ct, const SK &sk, const PK &pk,
+                            params::poly_p &poly_m, N &noise,
+                            prng::seed_t const &seed) {
+  using P = params::poly_p;
+
+  // Apply the NTT on poly_m
+  poly_m.ntt_pow_phi();
+
+  // Set the ciphertext pk
+  ct.pk = (PK *)&pk;
+
+  // c1 = a uniform, kept as its seed
+  ct.seed = seed;
+  P a;
+  prng::uniform_poly(a, ct.seed);
+
+  // c0 = small error + Delta*m - a*s
+  noise.fill(ct.c0);
+  ct.c0.ntt_pow_phi();
+  ct.c0 = ct.c0 + nfl::shoup(poly_m * pk.delta, pk.delta_shoup) -
+          nfl::shoup(a * sk.value, sk.value_shoup);
+}
+
+template <class SK, class PK, class C>
+void encrypt_poly_symmetric(C &ct, const SK &sk, const PK &pk,
+                            params::poly_p &poly_m) {
+  auto noise = util::global_noise(&params::fg_prng_enc);
+  encrypt_poly_symmetric(ct, sk, pk, poly_m, noise, prng::fresh_seed());
+}
 }  // namespace FV
 
 /**
@@ -854,6 +1721,21 @@ class message_t {
     return *this;
   };
 
+  /// Random generator on a given keystream (e.g. of a context_t worker)
+  message_t &random(prng::chacha20 &rng) {
+    // 128 random bits reduced modulo t: the bias is negligible for t < 2^64
+    mpz_class rnd(0);
+    for (int i = 0; i < 4; i++) {
+      rnd <<= 32;
+      rnd += static_cast<unsigned long>(rng.next_u32());
+    }
+    mpz_class t(params::plaintextModulus<T>::value());
+    rnd %= t;
+    message_t m = util::message_from_mpz_t<T>(rnd.get_mpz_t());
+    _value = m.getValue();
+    return *this;
+  }
+
   /// Operations +, -, *
   message_t &operator+=(message_t const &m) {
     _value = (_value + m._value) % params::plaintextModulus<T>::value();
@@ -1045,7 +1927,34 @@ inline void lift(std::array<mpz_t, params::polyZ_p::degree> &coefficients,
  * @param c        initial polynomial
  * @param ntt_form boolean to keep the NTT form if any
  */
+void convert_copy(params::polyZ_p &new_c, params::poly_p &other,
+                  bool ntt_form);
+
 void convert(params::polyZ_p &new_c, params::poly_p const &c, bool ntt_form) {
+  // Copy c
+  params::poly_p other{c};
+  convert_copy(new_c, other, ntt_form);
+}
+
+/**
+ * Convert a polynomial given as raw residues (nmoduli arrays of degree
+ * residues, e.g. in a mapped file) into a polynomial PZ
+ */
+void convert(params::polyZ_p &new_c,
+             typename params::poly_p::value_type const *c, bool ntt_form) {
+  using P = params::poly_p;
+  P other;
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    std::copy(c + cm * P::degree, c + (cm + 1) * P::degree, &other(cm, 0));
+  }
+  convert_copy(new_c, other, ntt_form);
+}
+
+/**
+ * Convert a copy of a polynomial P into a polynomial PZ (other is modified)
+ */
+void convert_copy(params::polyZ_p &new_c, params::poly_p &other,
+                  bool ntt_form) {
   using P = params::poly_p;
   using PZ = params::polyZ_p;
 
@@ -1053,9 +1962,6 @@ void convert(params::polyZ_p &new_c, params::poly_p const &c, bool ntt_form) {
                           sizeof(typename P::value_type) * CHAR_BIT +
                           nfl::static_log2<P::nmoduli>::value + 1;
 
-  // Copy c
-  P other{c};
-
   // Compute the inverse NTT if needed
   if (ntt_form) {
     other.invntt_pow_invphi();
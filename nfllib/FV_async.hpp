@@ -0,0 +1,249 @@
+/**
+ *
+ * Asynchronous FV operations
+ *
+ * An executor runs FV operations on a fixed set of threads, each with its own
+ * context_t worker (noise sampler, keystream, NTT scratch). The functions of
+ * FV::async submit encrypt, tensor, relinearize, multiply, add and decrypt to
+ * an executor and return a std::shared_future, so that a caller busy with
+ * something else (e.g. network I/O) can keep many operations in flight.
+ *
+ * Arguments are values or futures returned by earlier calls, so dependent
+ * operations can be chained without blocking the caller:
+ *
+ *   auto a = FV::async::encrypt(ex, pk, m0);
+ *   auto b = FV::async::encrypt(ex, pk, m1);
+ *   auto m = FV::async::decrypt(ex, sk, pk, FV::async::multiply(ex, a, b));
+ *
+ * A task waits for its arguments on the executor; tasks start in submission
+ * order, so what it waits for is already running or done.
+ *
+ * At most max_pending tasks wait to start: submit() blocks the caller when
+ * the queue is full, which bounds the memory of the operations in flight.
+ * Keys are taken by reference and must outlive the tasks.
+ *
+ * Include after FV.hpp. Needs -pthread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "FV_context.hpp"
+
+namespace FV {
+namespace async {
+
+/**
+ * Threads with one context_t worker each, running submitted tasks in order
+ */
+class executor {
+ public:
+  using worker_t = context_t::worker_t;
+
+  /**
+   * Constructor
+   * @param context     context the workers are forked from (in order)
+   * @param threads     number of threads, 0 for one per hardware thread
+   * @param max_pending tasks waiting to start before submit() blocks, 0 for
+   *                    four per thread
+   */
+  explicit executor(context_t &context, size_t threads = 0,
+                    size_t max_pending = 0) {
+    if (threads == 0) {
+      threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    _max_pending = max_pending != 0 ? max_pending : 4 * threads;
+    for (size_t t = 0; t < threads; t++) {
+      _threads.emplace_back(&executor::run, this, context.fork());
+    }
+  }
+  executor(executor const &) = delete;
+  executor &operator=(executor const &) = delete;
+
+  /// Run the tasks still queued, then stop the threads
+  ~executor() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _not_empty.notify_all();
+    for (std::thread &thread : _threads) {
+      thread.join();
+    }
+  }
+
+  /// Number of threads
+  size_t size() const { return _threads.size(); }
+
+  /**
+   * Queue fn(worker) and return the future of its result; blocks while
+   * max_pending tasks are waiting to start
+   */
+  template <class F>
+  std::future<typename std::result_of<F(worker_t &)>::type> submit(F fn) {
+    using R = typename std::result_of<F(worker_t &)>::type;
+    auto task = std::make_shared<std::packaged_task<R(worker_t &)>>(fn);
+    std::future<R> future = task->get_future();
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _not_full.wait(lock, [this] { return _queue.size() < _max_pending; });
+      _queue.emplace_back([task](worker_t &worker) { (*task)(worker); });
+    }
+    _not_empty.notify_one();
+    return future;
+  }
+
+ private:
+  std::vector<std::thread> _threads;
+  std::deque<std::function<void(worker_t &)>> _queue;
+  std::mutex _mutex;
+  std::condition_variable _not_empty, _not_full;
+  size_t _max_pending;
+  bool _stop = false;
+
+  void run(worker_t worker) {
+    for (;;) {
+      std::function<void(worker_t &)> job;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _not_empty.wait(lock, [this] { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+          return;
+        }
+        job = std::move(_queue.front());
+        _queue.pop_front();
+      }
+      _not_full.notify_one();
+      job(worker);
+    }
+  }
+};
+
+namespace detail {
+/// Value of an argument given directly or as a future
+template <class T>
+T const &get(T const &value) {
+  return value;
+}
+template <class T>
+T const &get(std::shared_future<T> const &future) {
+  return future.get();
+}
+}  // namespace detail
+
+/**
+ * Encryption with the public key
+ * @param poly_m polynomial (params::poly_p, not in NTT form) or future of one
+ */
+template <class M>
+std::shared_future<ciphertext_t> encrypt_poly(executor &ex, pk_t const &pk,
+                                              M poly_m) {
+  pk_t const *key = &pk;
+  return ex
+      .submit([key, poly_m](executor::worker_t &worker) {
+        params::poly_p m{detail::get(poly_m)};
+        ciphertext_t ct;
+        FV::encrypt_poly(ct, *key, m, worker);
+        return ct;
+      })
+      .share();
+}
+
+/// Encryption of a message (mess_t or future of one)
+template <class M>
+std::shared_future<ciphertext_t> encrypt(executor &ex, pk_t const &pk,
+                                         M message) {
+  pk_t const *key = &pk;
+  return ex
+      .submit([key, message](executor::worker_t &worker) {
+        params::poly_p m{detail::get(message).getValue()};
+        ciphertext_t ct;
+        FV::encrypt_poly(ct, *key, m, worker);
+        return ct;
+      })
+      .share();
+}
+
+/// Sum of two ciphertexts
+template <class A, class B>
+std::shared_future<ciphertext_t> add(executor &ex, A lhs, B rhs) {
+  return ex
+      .submit([lhs, rhs](executor::worker_t &) {
+        return detail::get(lhs) + detail::get(rhs);
+      })
+      .share();
+}
+
+/// Tensor product of two ciphertexts (to be relinearized)
+template <class A, class B>
+std::shared_future<tensor_ciphertext_t> tensor(executor &ex, A lhs, B rhs) {
+  return ex
+      .submit([lhs, rhs](executor::worker_t &) {
+        return FV::tensor(detail::get(lhs), detail::get(rhs));
+      })
+      .share();
+}
+
+/// Relinearization of a tensor product
+template <class T>
+std::shared_future<ciphertext_t> relinearize(executor &ex, T ct) {
+  return ex
+      .submit([ct](executor::worker_t &) {
+        return FV::relinearize(detail::get(ct));
+      })
+      .share();
+}
+
+/// Product of two ciphertexts (tensor product and relinearization)
+template <class A, class B>
+std::shared_future<ciphertext_t> multiply(executor &ex, A lhs, B rhs) {
+  return ex
+      .submit([lhs, rhs](executor::worker_t &) {
+        return detail::get(lhs) * detail::get(rhs);
+      })
+      .share();
+}
+
+/// Decryption of the whole polynomial
+template <class C>
+std::shared_future<std::vector<mpz_class>> decrypt_poly(executor &ex,
+                                                        sk_t const &sk,
+                                                        pk_t const &pk, C ct) {
+  sk_t const *secret = &sk;
+  pk_t const *key = &pk;
+  return ex
+      .submit([secret, key, ct](executor::worker_t &) {
+        std::vector<mpz_class> poly;
+        FV::decrypt_poly(poly, *secret, *key, detail::get(ct));
+        return poly;
+      })
+      .share();
+}
+
+/// Decryption of a message (constant coefficient)
+template <class C>
+std::shared_future<mess_t> decrypt(executor &ex, sk_t const &sk,
+                                   pk_t const &pk, C ct) {
+  sk_t const *secret = &sk;
+  pk_t const *key = &pk;
+  return ex
+      .submit([secret, key, ct](executor::worker_t &) {
+        mess_t message;
+        FV::decrypt(message, *secret, *key, detail::get(ct));
+        return message;
+      })
+      .share();
+}
+
+}  // namespace async
+}  // namespace FV
@@ -0,0 +1,102 @@
+/**
+ *
+ * Batch encryption and decryption for FV
+ *
+ * encrypt_batch and decrypt_batch spread a span of plaintexts or ciphertexts
+ * (pointer + count) over a thread pool. Every worker owns a Gaussian sampler
+ * and NTT scratch, and the noise of the i-th ciphertext is drawn from stream i
+ * of the batch seed, so the result only depends on the seed and not on the
+ * number of threads or on the scheduling. encrypt_batch draws a fresh seed
+ * for every batch. encrypt_batch_reproducible takes the seed from the caller,
+ * for tests and reproducible benchmarks only: two batches under the same seed
+ * share their noise, and subtracting their i-th ciphertexts gives Delta times
+ * the difference of the messages.
+ *
+ * Include after FV.hpp.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Per-worker state of encrypt_batch: noise sampler (on a shared table) and
+ * NTT scratch
+ */
+namespace FV {
+struct encryption_workspace {
+  explicit encryption_workspace(
+      std::shared_ptr<prng::cdt_table const> const &table)
+      : noise(table, prng::seed_t{}) {}
+
+  prng::cdt_gaussian noise;
+  params::poly_p u;
+};
+}  // namespace FV
+
+/**
+ * Encrypt count polynomials under a given noise seed, for tests and
+ * reproducible benchmarks; use encrypt_batch otherwise
+ * @param cts      ciphertexts (count of them, passed by reference)
+ * @param messages polynomials to encrypt (put in NTT form, as encrypt_poly)
+ * @param count    number of polynomials
+ * @param pk       public key
+ * @param seed     seed of the noise; the same seed gives the same ciphertexts,
+ *                 so it must never be reused to encrypt different messages
+ *                 (the difference of the ciphertexts reveals the difference
+ *                 of the messages)
+ * @param pool     thread pool
+ */
+namespace FV {
+template <class PK, class C>
+void encrypt_batch_reproducible(C *cts, params::poly_p *messages,
+                                size_t count, const PK &pk,
+                                prng::seed_t const &seed,
+                                util::thread_pool &pool) {
+  auto table = prng::shared_cdt_table();
+  std::vector<encryption_workspace> workspaces(pool.size(),
+                                               encryption_workspace(table));
+  pool.parallel_for(count, [&](size_t worker, size_t i) {
+    encryption_workspace &ws = workspaces[worker];
+    ws.noise.reseed(seed, i);
+    encrypt_poly(cts[i], pk, messages[i], ws.noise, ws.u);
+  });
+}
+
+/**
+ * Encrypt count polynomials, with a fresh noise seed (prng::fresh_seed())
+ * @param cts      ciphertexts (count of them, passed by reference)
+ * @param messages polynomials to encrypt (put in NTT form, as encrypt_poly)
+ * @param count    number of polynomials
+ * @param pk       public key
+ * @param pool     thread pool
+ */
+template <class PK, class C>
+void encrypt_batch(C *cts, params::poly_p *messages, size_t count,
+                   const PK &pk, util::thread_pool &pool) {
+  encrypt_batch_reproducible(cts, messages, count, pk, prng::fresh_seed(),
+                             pool);
+}
+}  // namespace FV
+
+/**
+ * Decrypt count ciphertexts
+ * @param polys_mpz polynomials of mpz values (count of them, initialized)
+ * @param cts       ciphertexts
+ * @param count     number of ciphertexts
+ * @param sk        secret key
+ * @param pk        public key
+ * @param pool      thread pool
+ */
+namespace FV {
+template <class SK, class PK, class C>
+void decrypt_batch(std::array<mpz_t, params::poly_p::degree> *polys_mpz,
+                   C const *cts, size_t count, const SK &sk, const PK &pk,
+                   util::thread_pool &pool) {
+  pool.parallel_for(count, [&](size_t, size_t i) {
+    decrypt_poly(polys_mpz[i], sk, pk, cts[i]);
+  });
+}
+}  // namespace FV
@@ -0,0 +1,124 @@
+/**
+ *
+ * Thread-safe randomness for FV
+ *
+ * The default key generation and encryption draw their noise from the
+ * process-wide samplers of params (fg_prng_*), which cannot be shared between
+ * threads. A context_t owns a master seed and the sampler tables, and hands
+ * out workers: every worker has its own Gaussian sampler, keystream for seeds
+ * and messages, and NTT scratch, so threads that each use their own worker
+ * never share mutable state and need no locks.
+ *
+ * A worker is forked from the master seed with the next stream number, so a
+ * program that forks its workers in a fixed order is reproducible.
+ *
+ * Include after FV.hpp.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace FV {
+class context_t {
+ public:
+  /**
+   * Constructor
+   * @param master_seed seed all the workers are derived from
+   * @param sigma       standard deviation of the noise
+   */
+  explicit context_t(prng::seed_t const &master_seed = prng::fresh_seed(),
+                     double sigma = 8.0)
+      : _master_seed(master_seed),
+        _table(prng::shared_cdt_table(sigma)) {}
+
+  context_t(context_t const &) = delete;
+  context_t &operator=(context_t const &) = delete;
+
+  /**
+   * State of one thread; not to be shared between threads
+   */
+  class worker_t {
+   public:
+    /// Sampler of the small polynomials (keys, encryption noise)
+    prng::cdt_gaussian noise;
+    /// Keystream for the seeds of uniform polynomials and random messages
+    prng::chacha20 rng;
+    /// NTT scratch of the encryption
+    params::poly_p u;
+
+    /// Fresh seed for a uniform polynomial
+    prng::seed_t next_seed() {
+      prng::seed_t seed;
+      rng.fill(seed.data(), seed.size());
+      return seed;
+    }
+
+   private:
+    friend class context_t;
+    worker_t(std::shared_ptr<prng::cdt_table const> const &table,
+             prng::seed_t const &master_seed, uint64_t stream)
+        : noise(table, master_seed, 2 * stream),
+          rng(master_seed, 2 * stream + 1) {}
+  };
+
+  /// New worker (thread-safe)
+  worker_t fork() {
+    return worker_t(_table, _master_seed, _next_stream.fetch_add(1));
+  }
+
+  /// Noise table shared by the workers
+  prng::cdt_table const &table() const { return *_table; }
+
+ private:
+  prng::seed_t const _master_seed;
+  std::shared_ptr<prng::cdt_table const> const _table;
+  std::atomic<uint64_t> _next_stream{0};
+};
+}  // namespace FV
+
+/**
+ * Key generation with the sampler and keystream of a worker
+ */
+namespace FV {
+inline sk_t make_sk(context_t::worker_t &worker) { return sk_t(worker.noise); }
+
+inline std::unique_ptr<evk_t> make_evk(context_t::worker_t &worker,
+                                       sk_t const &sk, size_t word_size,
+                                       evk_options const &options =
+                                           evk_options()) {
+  return std::unique_ptr<evk_t>(new evk_t(sk, word_size, worker.noise,
+                                          worker.next_seed(), options));
+}
+
+inline std::unique_ptr<pk_t> make_pk(context_t::worker_t &worker,
+                                     sk_t const &sk, evk_t const &evk) {
+  return std::unique_ptr<pk_t>(
+      new pk_t(sk, evk, worker.noise, worker.next_seed()));
+}
+}  // namespace FV
+
+/**
+ * Encryption with the sampler and scratch of a worker
+ * @param ct     ciphertext (passed by reference)
+ * @param pk     public key
+ * @param poly_m polynomial to encrypt
+ * @param worker state of the calling thread
+ */
+namespace FV {
+template <class PK, class C>
+void encrypt_poly(C &ct, const PK &pk, params::poly_p &poly_m,
+                  context_t::worker_t &worker) {
+  encrypt_poly(ct, pk, poly_m, worker.noise, worker.u);
+}
+
+template <class SK, class PK, class C>
+void encrypt_poly_symmetric(C &ct, const SK &sk, const PK &pk,
+                            params::poly_p &poly_m,
+                            context_t::worker_t &worker) {
+  encrypt_poly_symmetric(ct, sk, pk, poly_m, worker.noise,
+                         worker.next_seed());
+}
+}  // namespace FV
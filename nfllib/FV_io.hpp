@@ -0,0 +1,637 @@
+/**
+ *
+ * Binary storage of FV keys and ciphertext batches
+ *
+ * Every file starts with a 128-byte header followed by 64-byte aligned
+ * residue arrays in the in-memory layout, so that a key can be loaded
+ * either by reading it (read_*) or by mapping it (map_*). A mapped evaluation
+ * key is used in place (zero-copy); secret and public keys are small and are
+ * copied out of the mapping.
+ *
+ * Layouts (each polynomial is nmoduli * degree residues):
+ *  - sk:  value | value_shoup
+ *  - evk: the flat evk_t block, ell pairs of pair_size residues, or of
+ *         compact_pair_size residues when flag_compact is set (values[i][1]
+ *         is then regenerated from the seed in the header)
+ *  - pk:  b | b_shoup (a is expanded from the seed in the header)
+ *  - ciphertexts: count ciphertexts by columns, the c0 of every ciphertext
+ *         then the c1 of every ciphertext; written by ciphertext_writer and
+ *         mapped by ciphertext_file, which hands out ciphertext_views on the
+ *         mapping (usable by +, - and * without copying)
+ *
+ * Seeded ciphertexts (secret-key encryption) are sent as seed | c0 with
+ * serialize/deserialize.
+ *
+ * Include after FV.hpp.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FV {
+namespace io {
+
+/// Current version of the format, to be increased on any layout change
+constexpr uint32_t format_version = 2;
+/// Alignment of the header and of every array in the file
+constexpr size_t file_alignment = 64;
+
+enum class kind_t : uint32_t { sk = 1, evk = 2, pk = 3, ciphertexts = 4 };
+
+/// Header flags
+constexpr uint64_t flag_compact = 1;  // uniform halves stored as the seed
+
+/**
+ * Header of every file
+ */
+struct alignas(64) header_t {
+  char magic[8];                // "FVNFLLIB"
+  uint32_t version;             // format_version
+  uint32_t kind;                // kind_t
+  uint64_t degree;              // params::poly_p::degree
+  uint64_t nmoduli;             // params::poly_p::nmoduli
+  uint32_t value_size;          // sizeof(params::poly_p::value_type)
+  uint32_t word_size;           // evaluation key only, 0 otherwise
+  uint64_t count;               // elements that follow (evk: ell, ciphertexts)
+  uint64_t params_fingerprint;  // see fingerprint()
+  uint64_t payload_bytes;       // bytes after the header
+  uint64_t flags;               // flag_compact
+  prng::seed_t seed;            // seed of the uniform components (evk, pk)
+  uint8_t reserved[24];
+};
+static_assert(sizeof(header_t) == 2 * file_alignment,
+              "header must be 128 bytes");
+
+/**
+ * Fingerprint of the parameter set (degree, moduli, plaintext modulus), used
+ * to reject a file produced with other parameters
+ */
+inline uint64_t fingerprint() {
+  using P = params::poly_p;
+  uint64_t h = 1469598103934665603ULL;  // FNV-1a
+  auto mix = [&h](uint64_t v) {
+    for (size_t i = 0; i < sizeof(v); i++) {
+      h ^= (v >> (8 * i)) & 0xff;
+      h *= 1099511628211ULL;
+    }
+  };
+  mix(P::degree);
+  mix(P::nmoduli);
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    mix(P::get_modulus(cm));
+  }
+  for (char c : params::plaintextModulus<mpz_class>::value().get_str()) {
+    mix(static_cast<unsigned char>(c));
+  }
+  return h;
+}
+
+inline header_t make_header(kind_t kind, uint64_t count, uint64_t payload_bytes,
+                            uint32_t word_size = 0, uint64_t flags = 0,
+                            prng::seed_t const *seed = nullptr) {
+  using P = params::poly_p;
+  header_t header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "FVNFLLIB", sizeof(header.magic));
+  header.version = format_version;
+  header.kind = static_cast<uint32_t>(kind);
+  header.degree = P::degree;
+  header.nmoduli = P::nmoduli;
+  header.value_size = sizeof(typename P::value_type);
+  header.word_size = word_size;
+  header.count = count;
+  header.params_fingerprint = fingerprint();
+  header.payload_bytes = payload_bytes;
+  header.flags = flags;
+  if (seed != nullptr) {
+    header.seed = *seed;
+  }
+  return header;
+}
+
+inline void check_header(header_t const &header, kind_t kind,
+                         std::string const &path) {
+  using P = params::poly_p;
+  if (std::memcmp(header.magic, "FVNFLLIB", sizeof(header.magic)) != 0) {
+    throw std::runtime_error(path + ": not an FV file");
+  }
+  if (header.version != format_version) {
+    throw std::runtime_error(path + ": unsupported format version " +
+                             std::to_string(header.version));
+  }
+  if (header.kind != static_cast<uint32_t>(kind)) {
+    throw std::runtime_error(path + ": wrong content type");
+  }
+  if (header.degree != P::degree || header.nmoduli != P::nmoduli ||
+      header.value_size != sizeof(typename P::value_type) ||
+      header.params_fingerprint != fingerprint()) {
+    throw std::runtime_error(path + ": parameters do not match");
+  }
+}
+
+/// Bytes of one polynomial in the file
+constexpr size_t poly_bytes =
+    params::poly_p::degree * params::poly_p::nmoduli *
+    sizeof(typename params::poly_p::value_type);
+static_assert(poly_bytes % file_alignment == 0,
+              "polynomials must keep the 64-byte alignment of the file");
+
+/**
+ * Copy between polynomials and raw residue arrays
+ */
+inline void poly_to_raw(typename params::poly_p::value_type *dst,
+                        params::poly_p const &p) {
+  using P = params::poly_p;
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    std::memcpy(dst + cm * P::degree, &p(cm, 0),
+                P::degree * sizeof(typename P::value_type));
+  }
+}
+inline void raw_to_poly(params::poly_p &p,
+                        typename params::poly_p::value_type const *src) {
+  using P = params::poly_p;
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    std::memcpy(&p(cm, 0), src + cm * P::degree,
+                P::degree * sizeof(typename P::value_type));
+  }
+}
+
+/// Size in bytes of a stored key (header included)
+inline size_t file_bytes(std::string const &path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    throw std::runtime_error(path + ": cannot stat");
+  }
+  return st.st_size;
+}
+
+/**
+ * Read-only view of a whole file mapped with mmap (private, copy-on-write)
+ */
+class mapped_file {
+ public:
+  explicit mapped_file(std::string const &path, bool populate = true) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(path + ": cannot open");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(header_t)) {
+      close(fd);
+      throw std::runtime_error(path + ": truncated file");
+    }
+    _bytes = st.st_size;
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate) {
+      flags |= MAP_POPULATE;
+    }
+#endif
+    _base = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+    close(fd);
+    if (_base == MAP_FAILED) {
+      _base = nullptr;
+      throw std::runtime_error(path + ": mmap failed");
+    }
+  }
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+  ~mapped_file() {
+    if (_base != nullptr) {
+      munmap(_base, _bytes);
+    }
+  }
+
+  header_t const &header() const {
+    return *static_cast<header_t const *>(_base);
+  }
+  template <typename T>
+  T const *payload() const {
+    return reinterpret_cast<T const *>(static_cast<unsigned char *>(_base) +
+                                       sizeof(header_t));
+  }
+  size_t size() const { return _bytes; }
+
+  /// madvise on the bytes [offset, offset + bytes) of the file, shrunk to
+  /// whole pages
+  void advise(size_t offset, size_t bytes, int advice) const {
+    size_t const page = sysconf(_SC_PAGESIZE);
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = std::min(offset + bytes, _bytes) / page * page;
+    if (_base != nullptr && begin < end) {
+      madvise(static_cast<unsigned char *>(_base) + begin, end - begin, advice);
+    }
+  }
+
+  /// Give up ownership of the mapping (to be adopted by an aligned_buffer)
+  void *release() {
+    void *base = _base;
+    _base = nullptr;
+    return base;
+  }
+
+ private:
+  void *_base = nullptr;
+  size_t _bytes = 0;
+};
+
+namespace detail {
+inline void write_file(std::string const &path, header_t const &header,
+                       void const *payload, size_t bytes) {
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(path + ": cannot create");
+  }
+  file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  file.write(static_cast<char const *>(payload), bytes);
+  if (!file) {
+    throw std::runtime_error(path + ": write failed");
+  }
+}
+
+inline header_t read_header(std::ifstream &file, kind_t kind,
+                            std::string const &path) {
+  header_t header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    throw std::runtime_error(path + ": truncated file");
+  }
+  check_header(header, kind, path);
+  return header;
+}
+
+inline void check_size(header_t const &header, size_t expected,
+                       std::string const &path) {
+  if (header.payload_bytes != expected) {
+    throw std::runtime_error(path + ": unexpected payload size");
+  }
+}
+
+inline void check_mapped(mapped_file const &file, kind_t kind,
+                         size_t expected, std::string const &path) {
+  check_header(file.header(), kind, path);
+  check_size(file.header(), expected, path);
+  if (file.size() < sizeof(header_t) + expected) {
+    throw std::runtime_error(path + ": truncated file");
+  }
+}
+
+/// Read a sequence of polynomials from a stream
+inline void read_polys(std::ifstream &file, std::string const &path,
+                       std::vector<params::poly_p *> const &polys) {
+  std::vector<typename params::poly_p::value_type> buffer(
+      poly_bytes / sizeof(typename params::poly_p::value_type));
+  for (params::poly_p *p : polys) {
+    if (!file.read(reinterpret_cast<char *>(buffer.data()), poly_bytes)) {
+      throw std::runtime_error(path + ": truncated file");
+    }
+    raw_to_poly(*p, buffer.data());
+  }
+}
+}  // namespace detail
+
+/**
+ * Writers
+ */
+inline void write(std::string const &path, sk_t const &sk) {
+  using value_type = typename params::poly_p::value_type;
+  std::vector<value_type> raw(2 * poly_bytes / sizeof(value_type));
+  poly_to_raw(raw.data(), sk.value);
+  poly_to_raw(raw.data() + raw.size() / 2, sk.value_shoup);
+  detail::write_file(path, make_header(kind_t::sk, 1, 2 * poly_bytes),
+                     raw.data(), 2 * poly_bytes);
+}
+
+/**
+ * Write the evaluation key; a compact file only stores values[i][0] and its
+ * Shoup data (half the size), whatever the layout of evk in memory
+ */
+inline void write(std::string const &path, evk_t const &evk,
+                  bool compact = true) {
+  using value_type = evk_t::value_type;
+  size_t stride = compact ? evk_t::compact_pair_size : evk_t::pair_size;
+  size_t bytes = evk.ell * stride * sizeof(value_type);
+  header_t header = make_header(kind_t::evk, evk.ell, bytes, evk.word_size,
+                                compact ? flag_compact : 0, &evk.seed);
+  if (compact == !evk.expanded) {
+    detail::write_file(path, header, evk.values.data(), bytes);
+    return;
+  }
+  // Change of layout: keep values[i][0] and its Shoup data of every pair
+  util::aligned_buffer<value_type> raw(evk.ell * evk_t::compact_pair_size);
+  for (size_t i = 0; i < evk.ell; i++) {
+    std::copy(evk.pair(i), evk.pair(i) + evk_t::compact_pair_size,
+              raw.data() + i * evk_t::compact_pair_size);
+  }
+  evk_t copy(evk.word_size, evk.seed, false, std::move(raw));
+  if (!compact) {
+    copy.expand();
+  }
+  detail::write_file(path, header, copy.values.data(), bytes);
+}
+
+inline void write(std::string const &path, pk_t const &pk) {
+  using value_type = typename params::poly_p::value_type;
+  size_t n = poly_bytes / sizeof(value_type);
+  std::vector<value_type> raw(2 * n);
+  poly_to_raw(raw.data(), pk.b);
+  poly_to_raw(raw.data() + n, pk.b_shoup);
+  detail::write_file(
+      path, make_header(kind_t::pk, 1, 2 * poly_bytes, 0, flag_compact, &pk.seed),
+      raw.data(), 2 * poly_bytes);
+}
+
+/**
+ * Readers (parse the file with buffered reads)
+ */
+inline sk_t read_sk(std::string const &path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(path + ": cannot open");
+  }
+  header_t header = detail::read_header(file, kind_t::sk, path);
+  detail::check_size(header, 2 * poly_bytes, path);
+  params::poly_p value, value_shoup;
+  detail::read_polys(file, path, {&value, &value_shoup});
+  return sk_t(value, value_shoup);
+}
+
+namespace detail {
+/// Residues of the evaluation key stored in a file with this header
+inline size_t evk_residues(header_t const &header, std::string const &path) {
+  if (header.word_size == 0 ||
+      header.count != evk_t::ell_for(header.word_size)) {
+    throw std::runtime_error(path + ": inconsistent evaluation key");
+  }
+  return header.count * ((header.flags & flag_compact)
+                             ? evk_t::compact_pair_size
+                             : evk_t::pair_size);
+}
+}  // namespace detail
+
+/**
+ * Read the evaluation key
+ * @param expand regenerate values[i][1] once at load time if the file is
+ *               compact; otherwise it is regenerated during each product
+ */
+inline std::unique_ptr<evk_t> read_evk(std::string const &path,
+                                       bool expand = true,
+                                       bool huge_pages = false) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(path + ": cannot open");
+  }
+  header_t header = detail::read_header(file, kind_t::evk, path);
+  size_t n = detail::evk_residues(header, path);
+  detail::check_size(header, n * sizeof(evk_t::value_type), path);
+  util::aligned_buffer<evk_t::value_type> values(n, huge_pages);
+  if (!file.read(reinterpret_cast<char *>(values.data()),
+                 header.payload_bytes)) {
+    throw std::runtime_error(path + ": truncated file");
+  }
+  std::unique_ptr<evk_t> evk(new evk_t(header.word_size, header.seed,
+                                       !(header.flags & flag_compact),
+                                       std::move(values)));
+  if (expand) {
+    evk->expand(huge_pages);
+  }
+  return evk;
+}
+
+inline std::unique_ptr<pk_t> read_pk(std::string const &path,
+                                     evk_t const &evk) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(path + ": cannot open");
+  }
+  header_t header = detail::read_header(file, kind_t::pk, path);
+  detail::check_size(header, 2 * poly_bytes, path);
+  params::poly_p b, b_shoup;
+  detail::read_polys(file, path, {&b, &b_shoup});
+  return std::unique_ptr<pk_t>(new pk_t(evk, header.seed, b, b_shoup));
+}
+
+/**
+ * Mappers (mmap the file; the evaluation key keeps the mapping)
+ */
+inline sk_t map_sk(std::string const &path) {
+  using value_type = typename params::poly_p::value_type;
+  mapped_file file(path);
+  detail::check_mapped(file, kind_t::sk, 2 * poly_bytes, path);
+  value_type const *raw = file.payload<value_type>();
+  params::poly_p value, value_shoup;
+  raw_to_poly(value, raw);
+  raw_to_poly(value_shoup, raw + poly_bytes / sizeof(value_type));
+  return sk_t(value, value_shoup);
+}
+
+/**
+ * Map the evaluation key. The mapping is used in place (zero-copy) unless
+ * expand is set and the file is compact, in which case the key is expanded
+ * into anonymous memory and the mapping is dropped.
+ */
+inline std::unique_ptr<evk_t> map_evk(std::string const &path,
+                                      bool expand = false) {
+  mapped_file file(path);
+  header_t const header = file.header();
+  check_header(header, kind_t::evk, path);
+  size_t n = detail::evk_residues(header, path);
+  detail::check_mapped(file, kind_t::evk, n * sizeof(evk_t::value_type), path);
+  size_t bytes = file.size();
+  auto values = util::aligned_buffer<evk_t::value_type>::adopt_mapping(
+      file.release(), bytes, sizeof(header_t), n);
+  std::unique_ptr<evk_t> evk(new evk_t(header.word_size, header.seed,
+                                       !(header.flags & flag_compact),
+                                       std::move(values)));
+  if (expand) {
+    evk->expand();
+  }
+  return evk;
+}
+
+inline std::unique_ptr<pk_t> map_pk(std::string const &path,
+                                    evk_t const &evk) {
+  using value_type = typename params::poly_p::value_type;
+  mapped_file file(path);
+  detail::check_mapped(file, kind_t::pk, 2 * poly_bytes, path);
+  value_type const *raw = file.payload<value_type>();
+  params::poly_p b, b_shoup;
+  raw_to_poly(b, raw);
+  raw_to_poly(b_shoup, raw + poly_bytes / sizeof(value_type));
+  return std::unique_ptr<pk_t>(new pk_t(evk, file.header().seed, b, b_shoup));
+}
+
+/**
+ * Seeded ciphertexts on the wire: the 32-byte seed of c1 followed by c0
+ */
+constexpr size_t seeded_ciphertext_bytes = sizeof(prng::seed_t) + poly_bytes;
+
+inline void serialize(uint8_t *out, seeded_ciphertext_t const &ct) {
+  std::memcpy(out, ct.seed.data(), ct.seed.size());
+  std::vector<typename params::poly_p::value_type> raw(
+      poly_bytes / sizeof(typename params::poly_p::value_type));
+  poly_to_raw(raw.data(), ct.c0);
+  std::memcpy(out + ct.seed.size(), raw.data(), poly_bytes);
+}
+
+inline void deserialize(seeded_ciphertext_t &ct, uint8_t const *in,
+                        pk_t const &pk) {
+  std::memcpy(ct.seed.data(), in, ct.seed.size());
+  std::vector<typename params::poly_p::value_type> raw(
+      poly_bytes / sizeof(typename params::poly_p::value_type));
+  std::memcpy(raw.data(), in + ct.seed.size(), poly_bytes);
+  raw_to_poly(ct.c0, raw.data());
+  ct.pk = (pk_t *)&pk;
+}
+
+/**
+ * Streaming writer of a batch of count ciphertexts: the file is sized when
+ * opened, and ciphertext i is written to slot i of the c0 and c1 columns with
+ * positioned writes, so memory use does not depend on count
+ */
+class ciphertext_writer {
+  using P = params::poly_p;
+
+ public:
+  ciphertext_writer(std::string const &path, size_t count)
+      : _path(path),
+        _count(count),
+        _buffer(poly_bytes / sizeof(typename P::value_type)) {
+    _fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+      throw std::runtime_error(path + ": cannot create");
+    }
+    // The destructor does not run if the constructor throws
+    try {
+      header_t header =
+          make_header(kind_t::ciphertexts, count, 2 * count * poly_bytes);
+      if (ftruncate(_fd, sizeof(header_t) + header.payload_bytes) != 0) {
+        throw std::runtime_error(path + ": cannot allocate the file");
+      }
+      put(0, &header, sizeof(header));
+    } catch (...) {
+      ::close(_fd);
+      throw;
+    }
+  }
+  ciphertext_writer(ciphertext_writer const &) = delete;
+  ciphertext_writer &operator=(ciphertext_writer const &) = delete;
+  ~ciphertext_writer() {
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+  }
+
+  /// Number of ciphertexts written so far
+  size_t size() const { return _written; }
+
+  void append(ciphertext_t const &ct) {
+    if (_written == _count) {
+      throw std::runtime_error(_path + ": batch already full");
+    }
+    poly_to_raw(_buffer.data(), ct.c0);
+    put(sizeof(header_t) + _written * poly_bytes, _buffer.data(), poly_bytes);
+    poly_to_raw(_buffer.data(), ct.c1);
+    put(sizeof(header_t) + (_count + _written) * poly_bytes, _buffer.data(),
+        poly_bytes);
+    _written++;
+  }
+
+  /// Close the file; every ciphertext of the batch must have been written
+  void close() {
+    if (_written != _count) {
+      throw std::runtime_error(_path + ": batch incomplete");
+    }
+    if (::close(_fd) != 0) {
+      _fd = -1;
+      throw std::runtime_error(_path + ": write failed");
+    }
+    _fd = -1;
+  }
+
+ private:
+  std::string _path;
+  int _fd;
+  size_t _count;
+  size_t _written = 0;
+  std::vector<typename P::value_type> _buffer;
+
+  void put(size_t offset, void const *data, size_t bytes) {
+    char const *src = static_cast<char const *>(data);
+    while (bytes > 0) {
+      ssize_t done = pwrite(_fd, src, bytes, offset);
+      if (done <= 0) {
+        throw std::runtime_error(_path + ": write failed");
+      }
+      src += done;
+      offset += done;
+      bytes -= done;
+    }
+  }
+};
+
+inline void write(std::string const &path, ciphertext_t const *cts,
+                  size_t count) {
+  ciphertext_writer writer(path, count);
+  for (size_t i = 0; i < count; i++) {
+    writer.append(cts[i]);
+  }
+  writer.close();
+}
+
+/**
+ * Batch of ciphertexts mapped from a file, read as views (zero-copy)
+ * The mapping is not populated and is advised for sequential access, so the
+ * file can be larger than the memory; release() drops the pages of
+ * ciphertexts already used.
+ */
+class ciphertext_file {
+  using P = params::poly_p;
+
+ public:
+  ciphertext_file(std::string const &path, pk_t &pk)
+      : _file(path, false), _pk(&pk) {
+    check_header(_file.header(), kind_t::ciphertexts, path);
+    _count = _file.header().count;
+    detail::check_mapped(_file, kind_t::ciphertexts, 2 * _count * poly_bytes,
+                         path);
+    _file.advise(sizeof(header_t), 2 * _count * poly_bytes, MADV_SEQUENTIAL);
+  }
+
+  /// Number of ciphertexts
+  size_t size() const { return _count; }
+
+  ciphertext_view operator[](size_t i) const {
+    typename P::value_type const *base =
+        _file.payload<typename P::value_type>();
+    size_t const n = poly_bytes / sizeof(typename P::value_type);
+    return ciphertext_view(base + i * n, base + (_count + i) * n, _pk);
+  }
+
+  /// Drop the mapped pages of ciphertexts [begin, end)
+  void release(size_t begin, size_t end) const {
+    size_t const bytes = (end - begin) * poly_bytes;
+    _file.advise(sizeof(header_t) + begin * poly_bytes, bytes, MADV_DONTNEED);
+    _file.advise(sizeof(header_t) + (_count + begin) * poly_bytes, bytes,
+                 MADV_DONTNEED);
+  }
+
+ private:
+  mapped_file _file;
+  pk_t *_pk;
+  size_t _count;
+};
+
+}  // namespace io
+}  // namespace FV
@@ -0,0 +1,72 @@
+/**
+ *
+ * Lazily built noise samplers for the FV parameters
+ *
+ * Building a FastGaussianNoise precomputes its tables, and a parameter block
+ * usually declares four of them (fg_prng_sk, _evk, _pk and _enc) as globals,
+ * so all four were built during static initialization of every binary, before
+ * main. Declaring them as shared_noise instead only records sigma: on first
+ * use each one builds its own Gaussian sampler (prng::cdt_gaussian) on a fresh
+ * seed, reading the CDT table that every sampler with the same sigma shares.
+ * Only the table is shared; the four samplers draw from independent streams.
+ *
+ *   FV::util::shared_noise fg_prng_sk(8.0);
+ *
+ * A sampler is not thread-safe (see FV_context.hpp for concurrent code);
+ * building it is.
+ *
+ * Does not need the parameters, so it can be included before them.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "FV_prng.hpp"
+
+namespace FV {
+namespace util {
+
+class shared_noise {
+ public:
+  using sampler_type = prng::cdt_gaussian;
+
+  explicit shared_noise(double sigma = 8.0) : _sigma(sigma) {}
+
+  shared_noise(shared_noise const &) = delete;
+  shared_noise &operator=(shared_noise const &) = delete;
+
+  ~shared_noise() {
+    if (_sampler) {
+      _sampler->~cdt_gaussian();
+    }
+  }
+
+  /// The sampler, built on first use
+  prng::cdt_gaussian &get() {
+    std::call_once(_once, [this] {
+      // In place: cdt_gaussian is over-aligned, which new ignores in C++11
+      _sampler = new (&_storage) prng::cdt_gaussian(
+          prng::shared_cdt_table(_sigma), prng::fresh_seed());
+    });
+    return *_sampler;
+  }
+
+  /// Fill p with noise from this sampler
+  template <class P>
+  void fill(P &p) {
+    get().fill(p);
+  }
+
+ private:
+  double _sigma;
+  std::once_flag _once;
+  std::aligned_storage<sizeof(prng::cdt_gaussian),
+                       alignof(prng::cdt_gaussian)>::type _storage;
+  prng::cdt_gaussian *_sampler = nullptr;
+};
+
+}  // namespace util
+}  // namespace FV
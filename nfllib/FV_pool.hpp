@@ -0,0 +1,124 @@
+/**
+ *
+ * Thread pool for the parallel parts of FV (key generation, batches)
+ *
+ * Needs -pthread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FV {
+namespace util {
+
+/**
+ * Fixed set of worker threads running parallel loops
+ * The calling thread takes part in the loop as worker 0.
+ * @param threads number of workers, 0 for one per hardware thread
+ */
+class thread_pool {
+ public:
+  explicit thread_pool(size_t threads = 0) {
+    if (threads == 0) {
+      threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    _size = threads;
+    for (size_t worker = 1; worker < _size; worker++) {
+      _threads.emplace_back([this, worker] { run(worker); });
+    }
+  }
+  thread_pool(thread_pool const &) = delete;
+  thread_pool &operator=(thread_pool const &) = delete;
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _wake.notify_all();
+    for (std::thread &thread : _threads) {
+      thread.join();
+    }
+  }
+
+  /// Number of workers (calling thread included)
+  size_t size() const { return _size; }
+
+  /**
+   * Call fn(worker, i) for every i in [0, count), with worker in [0, size())
+   * Indices are handed out in chunks; returns when all of them are done.
+   */
+  template <class F>
+  void parallel_for(size_t count, F const &fn, size_t chunk = 1) {
+    if (_size == 1 || count <= chunk) {
+      for (size_t i = 0; i < count; i++) {
+        fn(0, i);
+      }
+      return;
+    }
+    std::atomic<size_t> next(0);
+    std::function<void(size_t)> job = [&](size_t worker) {
+      for (size_t begin = next.fetch_add(chunk); begin < count;
+           begin = next.fetch_add(chunk)) {
+        size_t const end = std::min(count, begin + chunk);
+        for (size_t i = begin; i < end; i++) {
+          fn(worker, i);
+        }
+      }
+    };
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _job = &job;
+      _pending = _size - 1;
+      _generation++;
+    }
+    _wake.notify_all();
+    job(0);
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _pending == 0; });
+    _job = nullptr;
+  }
+
+ private:
+  size_t _size;
+  std::vector<std::thread> _threads;
+  std::mutex _mutex;
+  std::condition_variable _wake, _done;
+  std::function<void(size_t)> *_job = nullptr;
+  size_t _pending = 0;
+  size_t _generation = 0;
+  bool _stop = false;
+
+  void run(size_t worker) {
+    size_t seen = 0;
+    for (;;) {
+      std::function<void(size_t)> *job;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait(lock, [&] { return _stop || _generation != seen; });
+        if (_stop) {
+          return;
+        }
+        seen = _generation;
+        job = _job;
+      }
+      (*job)(worker);
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_pending == 0) {
+          _done.notify_one();
+        }
+      }
+    }
+  }
+};
+
+}  // namespace util
+}  // namespace FV
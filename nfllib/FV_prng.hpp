@@ -0,0 +1,502 @@
+/**
+ *
+ * Deterministic randomness for FV: a ChaCha20 stream keyed by a 32-byte seed,
+ * with the original state layout of Bernstein's ChaCha (64-bit block counter
+ * and 64-bit nonce, not the 32-bit counter and 96-bit nonce of RFC 8439).
+ * It is used to expand uniform polynomials from a seed so that they can be
+ * stored or sent as the seed alone, and to draw Gaussian noise from
+ * independent per-thread streams.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace FV {
+namespace prng {
+
+/// Seed of a uniform polynomial (256 bits)
+using seed_t = std::array<uint8_t, 32>;
+
+/**
+ * ChaCha20 keystream generator
+ * Blocks are computed `lanes` at a time (consecutive counters), with the
+ * lanes in the innermost loops so that the rounds vectorize: with AVX2 one
+ * register holds the same word of the 8 blocks. The keystream is the same
+ * whatever the path.
+ * @param seed   256-bit key
+ * @param stream 64-bit stream identifier (placed in the nonce), so that
+ *               several independent streams can be derived from one seed
+ */
+class chacha20 {
+ public:
+  /// Blocks computed per refill
+  static constexpr size_t lanes = 8;
+  /// 32-bit words per refill
+  static constexpr size_t buffer_words = 16 * lanes;
+
+  chacha20(seed_t const &seed, uint64_t stream = 0) { reseed(seed, stream); }
+
+  /// Restart the keystream from another seed and stream
+  void reseed(seed_t const &seed, uint64_t stream = 0) {
+    _state[0] = 0x61707865;
+    _state[1] = 0x3320646e;
+    _state[2] = 0x79622d32;
+    _state[3] = 0x6b206574;
+    for (size_t i = 0; i < 8; i++) {
+      _state[4 + i] = load32(seed.data() + 4 * i);
+    }
+    _state[12] = 0;  // block counter
+    _state[13] = 0;
+    _state[14] = static_cast<uint32_t>(stream);
+    _state[15] = static_cast<uint32_t>(stream >> 32);
+    _position = buffer_words;
+    _byte = 4;
+  }
+
+  /// Next 32 bits of the keystream
+  inline uint32_t next_u32() {
+    if (_position == buffer_words) {
+      refill();
+    }
+    return _block[_position++];
+  }
+
+  /// Next 64 bits of the keystream
+  inline uint64_t next_u64() {
+    uint64_t low = next_u32();
+    return low | (static_cast<uint64_t>(next_u32()) << 32);
+  }
+
+  /// Next n values of next_u64(), copied from the buffer in bulk
+  void fill_u64(uint64_t *out, size_t n) {
+    while (n > 0) {
+      if (_position == buffer_words) {
+        refill();
+      }
+      if (_position % 2 != 0) {
+        *out++ = next_u64();
+        n--;
+        continue;
+      }
+      size_t const m = std::min(n, (buffer_words - _position) / 2);
+      for (size_t i = 0; i < m; i++) {
+        out[i] = static_cast<uint64_t>(_block[_position + 2 * i]) |
+                 (static_cast<uint64_t>(_block[_position + 2 * i + 1]) << 32);
+      }
+      _position += 2 * m;
+      out += m;
+      n -= m;
+    }
+  }
+
+  /// Fill a byte buffer with the keystream
+  void fill(uint8_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      if (_byte == 4) {
+        _word = next_u32();
+        _byte = 0;
+      }
+      out[i] = static_cast<uint8_t>(_word >> (8 * _byte++));
+    }
+  }
+
+ private:
+  uint32_t _state[16];
+  alignas(64) uint32_t _block[buffer_words];
+  size_t _position = buffer_words;
+  uint32_t _word = 0;
+  size_t _byte = 4;
+
+  static inline uint32_t load32(uint8_t const *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+#ifdef __AVX2__
+  static inline __m256i rotl(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+  }
+  static inline void quarter_round(__m256i *x, int a, int b, int c, int d) {
+    x[a] = _mm256_add_epi32(x[a], x[b]);
+    x[d] = rotl(_mm256_xor_si256(x[d], x[a]), 16);
+    x[c] = _mm256_add_epi32(x[c], x[d]);
+    x[b] = rotl(_mm256_xor_si256(x[b], x[c]), 12);
+    x[a] = _mm256_add_epi32(x[a], x[b]);
+    x[d] = rotl(_mm256_xor_si256(x[d], x[a]), 8);
+    x[c] = _mm256_add_epi32(x[c], x[d]);
+    x[b] = rotl(_mm256_xor_si256(x[b], x[c]), 7);
+  }
+#else
+  typedef uint32_t row_t[lanes];
+  static inline void quarter_round(row_t *x, int a, int b, int c, int d) {
+    for (size_t l = 0; l < lanes; l++) {
+      uint32_t xa = x[a][l], xb = x[b][l], xc = x[c][l], xd = x[d][l];
+      xa += xb;
+      xd ^= xa;
+      xd = (xd << 16) | (xd >> 16);
+      xc += xd;
+      xb ^= xc;
+      xb = (xb << 12) | (xb >> 20);
+      xa += xb;
+      xd ^= xa;
+      xd = (xd << 8) | (xd >> 24);
+      xc += xd;
+      xb ^= xc;
+      xb = (xb << 7) | (xb >> 25);
+      x[a][l] = xa;
+      x[b][l] = xb;
+      x[c][l] = xc;
+      x[d][l] = xd;
+    }
+  }
+#endif
+
+  /// Compute the next `lanes` 64-byte blocks of the keystream
+  void refill() {
+    // Word i of block l is in[i][l]; only the counter differs between blocks
+    alignas(32) uint32_t in[16][lanes];
+    uint64_t const counter =
+        static_cast<uint64_t>(_state[12]) | (static_cast<uint64_t>(_state[13]) << 32);
+    for (size_t i = 0; i < 16; i++) {
+      for (size_t l = 0; l < lanes; l++) {
+        in[i][l] = _state[i];
+      }
+    }
+    for (size_t l = 0; l < lanes; l++) {
+      in[12][l] = static_cast<uint32_t>(counter + l);
+      in[13][l] = static_cast<uint32_t>((counter + l) >> 32);
+    }
+
+    alignas(32) uint32_t out[16][lanes];
+#ifdef __AVX2__
+    __m256i x[16];
+    for (size_t i = 0; i < 16; i++) {
+      x[i] = _mm256_load_si256(reinterpret_cast<__m256i const *>(in[i]));
+    }
+#else
+    row_t *x = out;
+    std::memcpy(out, in, sizeof(in));
+#endif
+    for (int i = 0; i < 10; i++) {
+      quarter_round(x, 0, 4, 8, 12);
+      quarter_round(x, 1, 5, 9, 13);
+      quarter_round(x, 2, 6, 10, 14);
+      quarter_round(x, 3, 7, 11, 15);
+      quarter_round(x, 0, 5, 10, 15);
+      quarter_round(x, 1, 6, 11, 12);
+      quarter_round(x, 2, 7, 8, 13);
+      quarter_round(x, 3, 4, 9, 14);
+    }
+#ifdef __AVX2__
+    for (size_t i = 0; i < 16; i++) {
+      _mm256_store_si256(reinterpret_cast<__m256i *>(out[i]), x[i]);
+    }
+#endif
+
+    // Add the input and transpose to the order of the keystream
+    for (size_t l = 0; l < lanes; l++) {
+      for (size_t i = 0; i < 16; i++) {
+        _block[16 * l + i] = out[i][l] + in[i][l];
+      }
+    }
+    uint64_t const next = counter + lanes;
+    _state[12] = static_cast<uint32_t>(next);
+    _state[13] = static_cast<uint32_t>(next >> 32);
+    _position = 0;
+  }
+};
+
+/**
+ * Fresh seed for a new polynomial, from a per-thread ChaCha20 stream keyed
+ * once by the operating system
+ */
+inline seed_t fresh_seed() {
+  static thread_local chacha20 source([] {
+    std::random_device device;
+    seed_t seed;
+    for (size_t i = 0; i < seed.size(); i += 4) {
+      uint32_t r = device();
+      std::memcpy(seed.data() + i, &r, 4);
+    }
+    return seed;
+  }());
+  seed_t seed;
+  source.fill(seed.data(), seed.size());
+  return seed;
+}
+
+/**
+ * Residues uniform modulo the moduli of P, by rejection sampling on the
+ * keystream. The i-th call to next(cm) for a given stream always returns the
+ * same value, so a polynomial can be regenerated coefficient by coefficient
+ * in the order (cm, k) in which uniform_poly fills it.
+ */
+template <class P>
+class uniform_residues {
+  using value_type = typename P::value_type;
+
+ public:
+  uniform_residues(seed_t const &seed, uint64_t stream = 0)
+      : _rng(seed, stream) {
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+      value_type mask = P::get_modulus(cm);
+      for (size_t shift = 1; shift < sizeof(value_type) * 8; shift <<= 1) {
+        mask |= mask >> shift;
+      }
+      _masks[cm] = mask;
+    }
+  }
+
+  /// Next residue modulo the cm-th modulus
+  inline value_type next(size_t cm) {
+    value_type const modulus = P::get_modulus(cm);
+    value_type x;
+    do {
+      x = static_cast<value_type>(_rng.next_u64()) & _masks[cm];
+    } while (x >= modulus);
+    return x;
+  }
+
+  /**
+   * Next n residues modulo the cm-th modulus, same as n calls to next(cm)
+   * Words are drawn in bulk, never more than the residues still missing, so
+   * the stream is consumed exactly as by next().
+   */
+  void fill(size_t cm, value_type *out, size_t n) {
+    value_type const modulus = P::get_modulus(cm);
+    value_type const mask = _masks[cm];
+    uint64_t words[256];
+    size_t k = 0;
+    while (k < n) {
+      size_t const m = std::min(n - k, sizeof(words) / sizeof(words[0]));
+      _rng.fill_u64(words, m);
+      for (size_t j = 0; j < m; j++) {
+        value_type const x = static_cast<value_type>(words[j]) & mask;
+        out[k] = x;
+        k += x < modulus;
+      }
+    }
+  }
+
+ private:
+  chacha20 _rng;
+  value_type _masks[P::nmoduli];
+};
+
+/**
+ * Fill p with residues uniform modulo each modulus. Uniform in NTT form is
+ * uniform, so the result is used as is.
+ * @param p      polynomial (any nfl polynomial type)
+ * @param seed   seed of the polynomial
+ * @param stream stream identifier (e.g. the index of a key component)
+ */
+template <class P>
+void uniform_poly(P &p, seed_t const &seed, uint64_t stream = 0) {
+  uniform_residues<P> rng(seed, stream);
+  for (size_t cm = 0; cm < P::nmoduli; cm++) {
+    rng.fill(cm, &p(cm, 0), P::degree);
+  }
+}
+
+/**
+ * Cumulative distribution table (CDT) of the discrete Gaussian of standard
+ * deviation sigma, folded on |x|: entry k is 2^63 * P(|x| <= k)
+ *
+ * The table stops at the first entry that rounds to 2^63 (about 9 sigma for
+ * sigma = 8), and at 13 sigma at most. It is immutable once built and can be
+ * shared by any number of samplers and threads.
+ */
+class cdt_table {
+ public:
+  explicit cdt_table(double sigma = 8.0) : _sigma(sigma) {
+    size_t const tail = static_cast<size_t>(std::ceil(13 * sigma));
+    std::vector<long double> rho(tail + 1);
+    long double total = 0;
+    for (size_t k = 0; k <= tail; k++) {
+      rho[k] = std::exp(-static_cast<long double>(k * k) / (2 * sigma * sigma));
+      total += k == 0 ? rho[k] : 2 * rho[k];
+    }
+    long double cumulative = 0;
+    long double const scale = std::ldexp(1.0L, 63);
+    for (size_t k = 0; k < tail; k++) {
+      cumulative += (k == 0 ? rho[k] : 2 * rho[k]) / total;
+      _cdt.push_back(
+          static_cast<uint64_t>(std::min(cumulative * scale, scale - 1)));
+      // Further entries would be equal to this one (saturated)
+      if (_cdt.back() == static_cast<uint64_t>(scale - 1)) {
+        break;
+      }
+    }
+  }
+
+  double sigma() const { return _sigma; }
+  size_t size() const { return _cdt.size(); }
+  uint64_t const *data() const { return _cdt.data(); }
+
+ private:
+  double _sigma;
+  std::vector<uint64_t> _cdt;
+};
+
+/**
+ * Table for sigma, built on first use and shared by every caller
+ */
+inline std::shared_ptr<cdt_table const> shared_cdt_table(double sigma = 8.0) {
+  static std::mutex mutex;
+  static std::map<double, std::shared_ptr<cdt_table const>> tables;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<cdt_table const> &table = tables[sigma];
+  if (!table) {
+    table = std::make_shared<cdt_table const>(sigma);
+  }
+  return table;
+}
+
+/**
+ * Discrete Gaussian sampler by inversion of a CDT, on a ChaCha20 stream
+ *
+ * Each sample uses one 64-bit word: the top bit is the sign and the other 63
+ * bits are compared with the whole table (no early exit, so the time does not
+ * depend on the sample). fill() draws a whole polynomial by blocks of
+ * samples, 16 at a time in AVX2 registers when available; it gives the same
+ * values as calls to next().
+ */
+class cdt_gaussian {
+ public:
+  /// Sampler of standard deviation sigma (on the shared table)
+  cdt_gaussian(seed_t const &seed, uint64_t stream = 0, double sigma = 8.0)
+      : cdt_gaussian(shared_cdt_table(sigma), seed, stream) {}
+
+  /// Sampler reading a shared table
+  cdt_gaussian(std::shared_ptr<cdt_table const> table, seed_t const &seed,
+               uint64_t stream = 0)
+      : _rng(seed, stream), _table(std::move(table)) {}
+
+  /// Restart the stream (the table is kept)
+  void reseed(seed_t const &seed, uint64_t stream = 0) {
+    _rng.reseed(seed, stream);
+  }
+
+  /// Next sample
+  inline int64_t next() {
+    uint64_t const r = _rng.next_u64();
+    uint64_t const u = r & ((UINT64_C(1) << 63) - 1);
+    uint64_t const *cdt = _table->data();
+    size_t const n = _table->size();
+    int64_t magnitude = 0;
+    for (size_t k = 0; k < n; k++) {
+      magnitude += u >= cdt[k];
+    }
+    // x or -x, branch-free
+    int64_t const sign = -static_cast<int64_t>(r >> 63);
+    return (magnitude ^ sign) - sign;
+  }
+
+  /// Next n samples
+  void fill(int64_t *out, size_t n) {
+    uint64_t words[block];
+    uint64_t magnitudes[block];
+    for (size_t k0 = 0; k0 < n; k0 += block) {
+      size_t const m = n - k0 < block ? n - k0 : block;
+      sample_block(words, magnitudes, m);
+      for (size_t j = 0; j < m; j++) {
+        int64_t const sign = -static_cast<int64_t>(words[j] >> 63);
+        out[k0 + j] = (static_cast<int64_t>(magnitudes[j]) ^ sign) - sign;
+      }
+    }
+  }
+
+  /**
+   * Fill p with small noise (same integer in every modulus), as
+   * params::gauss_struct does
+   */
+  template <class P>
+  void fill(P &p) {
+    using value_type = typename P::value_type;
+    uint64_t words[block];
+    uint64_t magnitudes[block];
+    for (size_t k0 = 0; k0 < P::degree; k0 += block) {
+      size_t const m = P::degree - k0 < block ? P::degree - k0 : block;
+      sample_block(words, magnitudes, m);
+      for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        value_type const modulus = P::get_modulus(cm);
+        value_type *out = &p(cm, k0);
+        for (size_t j = 0; j < m; j++) {
+          value_type const x = static_cast<value_type>(magnitudes[j]);
+          bool const negative = (words[j] >> 63) != 0 && x != 0;
+          out[j] = negative ? modulus - x : x;
+        }
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t block = 256;
+
+  chacha20 _rng;
+  std::shared_ptr<cdt_table const> _table;
+
+  /// Draw m words and the magnitudes |x| they select in the table
+  void sample_block(uint64_t *words, uint64_t *magnitudes, size_t m) {
+    _rng.fill_u64(words, m);
+    uint64_t const *cdt = _table->data();
+    size_t const n = _table->size();
+    uint64_t const low = (UINT64_C(1) << 63) - 1;
+    size_t j = 0;
+#ifdef __AVX2__
+    size_t const vectorized = m - m % 16;
+    // 16 samples at a time in 4 registers; the entries and u are below 2^63,
+    // so u >= c is the signed comparison u > c - 1
+    __m256i const mask = _mm256_set1_epi64x(static_cast<int64_t>(low));
+    for (; j < vectorized; j += 16) {
+      __m256i const *in = reinterpret_cast<__m256i const *>(words + j);
+      __m256i const u0 = _mm256_and_si256(_mm256_loadu_si256(in), mask);
+      __m256i const u1 = _mm256_and_si256(_mm256_loadu_si256(in + 1), mask);
+      __m256i const u2 = _mm256_and_si256(_mm256_loadu_si256(in + 2), mask);
+      __m256i const u3 = _mm256_and_si256(_mm256_loadu_si256(in + 3), mask);
+      __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+      __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+      for (size_t k = 0; k < n; k++) {
+        __m256i const c = _mm256_set1_epi64x(static_cast<int64_t>(cdt[k] - 1));
+        acc0 = _mm256_sub_epi64(acc0, _mm256_cmpgt_epi64(u0, c));
+        acc1 = _mm256_sub_epi64(acc1, _mm256_cmpgt_epi64(u1, c));
+        acc2 = _mm256_sub_epi64(acc2, _mm256_cmpgt_epi64(u2, c));
+        acc3 = _mm256_sub_epi64(acc3, _mm256_cmpgt_epi64(u3, c));
+      }
+      __m256i *out = reinterpret_cast<__m256i *>(magnitudes + j);
+      _mm256_storeu_si256(out, acc0);
+      _mm256_storeu_si256(out + 1, acc1);
+      _mm256_storeu_si256(out + 2, acc2);
+      _mm256_storeu_si256(out + 3, acc3);
+    }
+#endif
+    for (; j < m; j++) {
+      uint64_t const u = words[j] & low;
+      uint64_t magnitude = 0;
+      for (size_t k = 0; k < n; k++) {
+        magnitude += u >= cdt[k];
+      }
+      magnitudes[j] = magnitude;
+    }
+  }
+};
+
+}  // namespace prng
+}  // namespace FV
@@ -0,0 +1,162 @@
+/**
+ *
+ * Choice of the FV ring degree and modulus for a target depth
+ *
+ * Given a multiplicative depth, the size of the plaintext modulus t and a
+ * security level, picks the smallest ring degree n (a power of two between
+ * 1024 and 32768) and the smallest number of 62-bit NFLlib moduli such that
+ *  - log2(q) stays below the bound of the Homomorphic Encryption Standard for
+ *    n and the security level (same table as MODULUS_Q in fv_params.hpp), and
+ *  - a ciphertext still decrypts after depth multiplications, following the
+ *    FV noise bounds (Fan-Vercauteren, Lepoint-Naehrig) with the heuristic
+ *    expansion factor 2*sqrt(n) and B = 6*sigma for the secret key and the
+ *    errors (both are Gaussian here).
+ *
+ * Everything is constexpr, so the choice can be made at compile time
+ *
+ *   using choice = FV::select::parameters<2, 17, 128>;
+ *   using poly_t = choice::poly_t;  // poly_from_modulus<uint64_t, 8192, 186>
+ *
+ * or at run time with the same functions (see fv_select.cpp).
+ * The bounds are in whole bits, rounded up.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <nfl.hpp>
+
+namespace FV {
+namespace select {
+
+/// Bits of one NFLlib modulus for uint64_t
+constexpr size_t modulus_word_bits = 62;
+/// Smallest and largest log2(n) in the table
+constexpr size_t min_log_degree = 10;
+constexpr size_t max_log_degree = 15;
+
+/// Largest log2(q) for n = 2^10..2^15 at 128, 192 and 256 bits of security
+constexpr size_t he_standard_bits[6][3] = {{27, 19, 15},    {53, 37, 29},
+                                           {103, 72, 56},   {206, 143, 111},
+                                           {413, 286, 222}, {829, 573, 445}};
+
+/// Security level column in he_standard_bits (3 when unknown)
+constexpr size_t security_column(size_t security) {
+  return security == 128 ? 0 : security == 192 ? 1 : security == 256 ? 2 : 3;
+}
+
+/// Largest log2(q) for n = 2^log_degree (0 when out of the table)
+constexpr size_t max_modulus_bits(size_t log_degree, size_t security) {
+  return log_degree < min_log_degree || log_degree > max_log_degree ||
+                 security_column(security) > 2
+             ? 0
+             : he_standard_bits[log_degree - min_log_degree]
+                               [security_column(security)];
+}
+
+/// ceil(log2(x)) for x >= 1
+constexpr size_t ceil_log2(uint64_t x, size_t bits = 0) {
+  return (uint64_t(1) << bits) >= x ? bits : ceil_log2(x, bits + 1);
+}
+
+constexpr size_t max3(size_t a, size_t b, size_t c) {
+  return a > b ? (a > c ? a : c) : (b > c ? b : c);
+}
+
+/// log2 of the expansion factor 2*sqrt(n)
+constexpr size_t expansion_bits(size_t log_degree) {
+  return 1 + (log_degree + 1) / 2;
+}
+
+/// log2 of the bound B = 6*sigma on the secret key and the errors
+constexpr size_t error_bits(size_t sigma) { return ceil_log2(6 * sigma); }
+
+/// Number of words of the evaluation key for a modulus of modulus_bits
+constexpr size_t ell(size_t modulus_bits, size_t word_size) {
+  return modulus_bits / word_size + 1;
+}
+
+/// Fresh ciphertext: B * (1 + 2*delta*B) <= 4*delta*B^2
+constexpr size_t fresh_noise_bits(size_t log_degree, size_t sigma) {
+  return 2 + expansion_bits(log_degree) + 2 * error_bits(sigma);
+}
+
+/**
+ * Noise after a relinearized product of two ciphertexts with noise v bits
+ * delta*t*(4 + delta*B)*V + delta^2*B*(B + t^2) + delta*ell*w*B, each term
+ * bounded separately and the sum by 4 times the largest one
+ */
+constexpr size_t product_noise_bits(size_t v, size_t log_degree,
+                                    size_t t_bits, size_t sigma,
+                                    size_t word_size, size_t modulus_bits) {
+  return 2 + max3(expansion_bits(log_degree) + t_bits +
+                      (expansion_bits(log_degree) + error_bits(sigma) + 1) + v,
+                  2 * expansion_bits(log_degree) + error_bits(sigma) +
+                      (2 * t_bits > error_bits(sigma) ? 2 * t_bits
+                                                      : error_bits(sigma)) +
+                      1,
+                  expansion_bits(log_degree) +
+                      ceil_log2(ell(modulus_bits, word_size)) + word_size +
+                      error_bits(sigma));
+}
+
+/// Noise after depth levels of products
+constexpr size_t noise_bits(size_t depth, size_t log_degree, size_t t_bits,
+                            size_t sigma, size_t word_size,
+                            size_t modulus_bits) {
+  return depth == 0 ? fresh_noise_bits(log_degree, sigma)
+                    : product_noise_bits(
+                          noise_bits(depth - 1, log_degree, t_bits, sigma,
+                                     word_size, modulus_bits),
+                          log_degree, t_bits, sigma, word_size, modulus_bits);
+}
+
+/**
+ * Size of the modulus chain (a multiple of 62 bits) needed to decrypt after
+ * depth products: the noise has to stay below q/(4t)
+ * The evaluation key term is taken with the largest modulus allowed for n.
+ */
+constexpr size_t modulus_bits(size_t depth, size_t log_degree, size_t t_bits,
+                              size_t security, size_t word_size,
+                              size_t sigma) {
+  return (noise_bits(depth, log_degree, t_bits, sigma, word_size,
+                     max_modulus_bits(log_degree, security)) +
+          t_bits + 2 + modulus_word_bits - 1) /
+         modulus_word_bits * modulus_word_bits;
+}
+
+/// Smallest log2(n) from log_degree on that meets the depth, 0 if none
+constexpr size_t log_degree(size_t depth, size_t t_bits, size_t security,
+                            size_t word_size, size_t sigma,
+                            size_t from = min_log_degree) {
+  return from > max_log_degree ? 0
+         : modulus_bits(depth, from, t_bits, security, word_size, sigma) <=
+                 max_modulus_bits(from, security)
+             ? from
+             : log_degree(depth, t_bits, security, word_size, sigma, from + 1);
+}
+
+/**
+ * Parameters for Depth products with a plaintext modulus of TBits bits at
+ * Security bits of security
+ */
+template <size_t Depth, size_t TBits, size_t Security, size_t WordSize = 32,
+          size_t Sigma = 8>
+struct parameters {
+  static_assert(security_column(Security) <= 2,
+                "the security level must be 128, 192 or 256");
+  static constexpr size_t log_degree =
+      select::log_degree(Depth, TBits, Security, WordSize, Sigma);
+  static_assert(log_degree != 0,
+                "no ring degree up to 32768 meets this depth and security");
+  static constexpr size_t degree = size_t(1) << log_degree;
+  static constexpr size_t modulus_bits = select::modulus_bits(
+      Depth, log_degree, TBits, Security, WordSize, Sigma);
+  static constexpr size_t nmoduli = modulus_bits / modulus_word_bits;
+
+  using poly_t = nfl::poly_from_modulus<uint64_t, degree, modulus_bits>;
+};
+
+}  // namespace select
+}  // namespace FV
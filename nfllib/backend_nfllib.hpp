@@ -0,0 +1,141 @@
+// Adaptador de FV (NFLlib) para el benchmark común de include/backend.h.
+// Los parámetros son los de fv_params.hpp, fijados en compilación, así que el
+// nivel de seguridad del constructor tiene que coincidir con SEC_LEVEL. El
+// contexto son los muestreadores de FV_context.hpp. Los mensajes van en los
+// coeficientes del polinomio: no hay ranuras que rotar y el producto en claro
+// es el de polinomios en Z_t[X]/(X^n + 1). La profundidad que se alcanza la
+// fija MODULUS_Q, así que el constructor la ignora.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gmpxx.h>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "fv_params.hpp"
+#include "FV_context.hpp"
+#include "FV_io.hpp"
+
+class backend_nfllib {
+public:
+    using texto_plano = FV::params::poly_p;
+    using cifrado = FV::ciphertext_t;
+    using producto = FV::tensor_ciphertext_t;
+    static constexpr bool rotacion = false;
+
+    static char const* nombre() { return "nfllib"; }
+
+    explicit backend_nfllib(int nivel_seguridad, int /*profundidad*/ = 2) : worker_(contexto_.fork()) {
+        if (nivel_seguridad != SEC_LEVEL) {
+            throw std::invalid_argument("nfllib está compilado para el nivel " + std::to_string(SEC_LEVEL));
+        }
+    }
+
+    void generar_claves() {
+        secret_key_.reset(new FV::sk_t(FV::make_sk(worker_)));
+        evaluation_key_ = FV::make_evk(worker_, *secret_key_, FV::params::word_size);
+        public_key_ = FV::make_pk(worker_, *secret_key_, *evaluation_key_);
+    }
+
+    void generar_claves_rotacion() {}
+
+    size_t ranuras() const { return texto_plano::degree; }
+    size_t grado() const { return texto_plano::degree; }
+    int64_t modulo() const { return FV::params::plaintextModulus<mpz_class>::value().get_si(); }
+
+    texto_plano codificar(std::vector<int64_t> const& valores) const {
+        texto_plano polinomio;
+        polinomio = 0;
+        for (size_t cm = 0; cm < texto_plano::nmoduli; cm++) {
+            for (size_t i = 0; i < valores.size(); i++) {
+                polinomio(cm, i) = valores[i];
+            }
+        }
+        return polinomio;
+    }
+
+    // encrypt_poly pasa el mensaje a NTT en el sitio
+    cifrado cifrar(texto_plano&& mensaje) const {
+        cifrado resultado;
+        FV::encrypt_poly(resultado, *public_key_, mensaje, worker_);
+        return resultado;
+    }
+
+    cifrado sumar(cifrado const& a, cifrado const& b) const { return a + b; }
+    producto multiplicar(cifrado const& a, cifrado const& b) const { return FV::tensor(a, b); }
+    cifrado relinealizar(producto p) const { return FV::relinearize(p); }
+
+    cifrado rotar(cifrado const&, int) const {
+        throw std::logic_error("FV con codificación en coeficientes no tiene rotaciones");
+    }
+
+    std::vector<int64_t> descifrar(cifrado const& c) const {
+        std::vector<mpz_class> polinomio;
+        FV::decrypt_poly(polinomio, *secret_key_, *public_key_, c);
+        std::vector<int64_t> valores(polinomio.size());
+        for (size_t i = 0; i < polinomio.size(); i++) {
+            valores[i] = polinomio[i].get_si();
+        }
+        return valores;
+    }
+
+    // Los residuos de c0 y c1, como en los ficheros de FV_io.hpp sin cabecera
+    void serializar(cifrado const& c, std::ostream& salida) const {
+        using value_type = texto_plano::value_type;
+        std::vector<value_type> raw(FV::io::poly_bytes / sizeof(value_type));
+        FV::io::poly_to_raw(raw.data(), c.c0);
+        salida.write(reinterpret_cast<char const*>(raw.data()), FV::io::poly_bytes);
+        FV::io::poly_to_raw(raw.data(), c.c1);
+        salida.write(reinterpret_cast<char const*>(raw.data()), FV::io::poly_bytes);
+    }
+
+    // Como FV::noise() pero con un polinomio: descifra bien mientras el ruido
+    // c0 + c1*s - Delta*m es menor que Delta/2 = q/(2t)
+    double presupuesto_ruido(cifrado const& c, std::vector<int64_t> const& esperado) const {
+        texto_plano m = codificar(esperado);
+        m.ntt_pow_phi();
+        texto_plano ruido{c.c0 + c.c1 * secret_key_->value - nfl::shoup(m * public_key_->delta, public_key_->delta_shoup)};
+        ruido.invntt_pow_invphi();
+        std::array<mpz_t, texto_plano::degree> coeficientes = ruido.poly2mpz();
+        size_t bits = 0;
+        for (size_t i = 0; i < texto_plano::degree; i++) {
+            FV::util::center(coeficientes[i], coeficientes[i], texto_plano::moduli_product(), evaluation_key_->qDivBy2);
+            bits = std::max(bits, mpz_sizeinbase(coeficientes[i], 2));
+            mpz_clear(coeficientes[i]);
+        }
+        return std::log2(mpz_class(texto_plano::moduli_product()).get_d()) - std::log2(double(modulo())) - 1 - double(bits);
+    }
+
+    std::vector<int64_t> producto_claro(std::vector<int64_t> const& a, std::vector<int64_t> const& b) const {
+        int64_t const t = modulo();
+        size_t const n = grado();
+        std::vector<int64_t> c(n, 0);
+        for (size_t i = 0; i < a.size(); i++) {
+            for (size_t j = 0; j < b.size(); j++) {
+                int64_t termino = a[i] * b[j] % t;
+                size_t k = (i + j) % n;
+                // X^n = -1
+                c[k] = (i + j < n) ? (c[k] + termino) % t : (c[k] - termino + t) % t;
+            }
+        }
+        return c;
+    }
+
+    std::vector<int64_t> rotacion_claro(std::vector<int64_t> const&, int) const {
+        throw std::logic_error("FV con codificación en coeficientes no tiene rotaciones");
+    }
+
+private:
+    FV::context_t contexto_;
+    mutable FV::context_t::worker_t worker_;
+    std::unique_ptr<FV::sk_t> secret_key_;
+    std::unique_ptr<FV::evk_t> evaluation_key_;
+    std::unique_ptr<FV::pk_t> public_key_;
+};
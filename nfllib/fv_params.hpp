@@ -0,0 +1,75 @@
+// Parámetros de FV compartidos por los benchmarks de NFLlib.
+// Se eligen en compilación desde el Makefile, por ejemplo:
+//   -DSEC_LEVEL=192 -DN_COEF=4096
+// Los valores por defecto son los de test_nfllib_criptosistema_128.cpp
+// El tamaño de palabra de la clave de evaluación se fija con -DWORD_SIZE=32 y
+// también se puede cambiar en ejecución (FV::params::word_size)
+// Con -DFV_EAGER_NOISE los muestreadores de NFLlib se construyen antes de main
+// (para medir el arranque, ver test_nfllib_startup.cpp)
+
+#pragma once
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <nfl.hpp>
+#include "FV_noise.hpp"
+
+#ifndef SEC_LEVEL
+#define SEC_LEVEL 128
+#endif
+
+#ifndef N_COEF
+#define N_COEF 16 // Coeficiente de los polinomios y grado del polinomio
+#endif
+
+#ifndef WORD_SIZE
+#define WORD_SIZE 32 // Bits por palabra en la descomposición de la relinearización
+#endif
+
+// Tamaño del módulo q definido por el homomorphic standard para cada nivel
+#ifndef MODULUS_Q
+#if SEC_LEVEL == 128
+#define MODULUS_Q 829
+#elif SEC_LEVEL == 192
+#define MODULUS_Q 573
+#elif SEC_LEVEL == 256
+#define MODULUS_Q 445
+#else
+#error "SEC_LEVEL debe ser 128, 192 o 256"
+#endif
+#endif
+
+/// Los parámetros se definen en el namespace y luego se llama a #include <fv.hpp>
+namespace FV {
+namespace params {
+using poly_t = nfl::poly_from_modulus<uint64_t, N_COEF, MODULUS_Q>;
+template <typename T>
+struct plaintextModulus;
+template <>
+struct plaintextModulus<mpz_class> {
+  static mpz_class value() {
+    return mpz_class("65537");
+  }
+};
+// Más pequeño: clave de evaluación más grande y relinearización más lenta, pero
+// menos ruido tras cada multiplicación
+size_t word_size = WORD_SIZE;
+using gauss_struct = nfl::gaussian<uint16_t, uint64_t, 2>;
+using gauss_t = nfl::FastGaussianNoise<uint16_t, uint64_t, 2>;
+#ifdef FV_EAGER_NOISE
+// Como antes: cuatro muestreadores construidos antes de main
+gauss_t fg_prng_sk(8.0, 128, 1 << 14);
+gauss_t fg_prng_evk(8.0, 128, 1 << 14);
+gauss_t fg_prng_pk(8.0, 128, 1 << 14);
+gauss_t fg_prng_enc(8.0, 128, 1 << 14);
+#else
+// Se construyen al usarse por primera vez; comparten solo la tabla y cada uno
+// tiene su propio flujo
+FV::util::shared_noise fg_prng_sk(8.0);
+FV::util::shared_noise fg_prng_evk(8.0);
+FV::util::shared_noise fg_prng_pk(8.0);
+FV::util::shared_noise fg_prng_enc(8.0);
+#endif
+}
+}  // namespace FV::params
+#include "FV.hpp"
@@ -0,0 +1,42 @@
+// Elige el grado del anillo y el tamaño del módulo q de FV (FV_select.hpp) para
+// una profundidad multiplicativa, un módulo de texto plano de bits_t bits y un
+// nivel de seguridad, y escribe en la salida estándar los flags para compilar
+// los benchmarks con ellos (ver el objetivo nfllib_auto del Makefile):
+//   ./fv_select 2 17 128  ->  -DN_COEF=8192 -DMODULUS_Q=186 -DSEC_LEVEL=128 -DWORD_SIZE=32
+// Por la salida de error se explica la elección y el tipo poly_from_modulus.
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include "FV_select.hpp"
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        std::cerr << "Uso: " << argv[0] << " <profundidad> <bits_t> <nivel_seguridad> [word_size]\n";
+        return 1;
+    }
+    size_t profundidad = std::strtoul(argv[1], nullptr, 10);
+    size_t bits_t = std::strtoul(argv[2], nullptr, 10);
+    size_t nivel = std::strtoul(argv[3], nullptr, 10);
+    size_t word_size = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 32;
+    size_t const sigma = 8;
+
+    if (FV::select::security_column(nivel) > 2) {
+        std::cerr << "Error: el nivel de seguridad debe ser 128, 192 o 256\n";
+        return 1;
+    }
+    size_t log_grado = FV::select::log_degree(profundidad, bits_t, nivel, word_size, sigma);
+    if (log_grado == 0) {
+        std::cerr << "Error: ningún grado hasta 32768 permite profundidad " << profundidad << " con seguridad " << nivel << "\n";
+        return 1;
+    }
+    size_t grado = size_t(1) << log_grado;
+    size_t bits_q = FV::select::modulus_bits(profundidad, log_grado, bits_t, nivel, word_size, sigma);
+    size_t ruido = FV::select::noise_bits(profundidad, log_grado, bits_t, sigma, word_size, FV::select::max_modulus_bits(log_grado, nivel));
+
+    std::cerr << "Profundidad " << profundidad << ", t de " << bits_t << " bits, seguridad " << nivel << ": n = " << grado
+              << ", q de " << bits_q << " bits (" << bits_q / FV::select::modulus_word_bits << " módulos, máximo " << FV::select::max_modulus_bits(log_grado, nivel)
+              << "), ruido estimado " << ruido << " bits\n";
+    std::cerr << "using poly_t = nfl::poly_from_modulus<uint64_t, " << grado << ", " << bits_q << ">;\n";
+    std::cout << "-DN_COEF=" << grado << " -DMODULUS_Q=" << bits_q << " -DSEC_LEVEL=" << nivel << " -DWORD_SIZE=" << word_size << std::endl;
+}
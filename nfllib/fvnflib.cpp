@@ -28,6 +28,7 @@
 #include <nfl.hpp>
 #include <thread>
 #include <vector>
+#include "FV_noise.hpp"
 
 /// include the FV homomorphic encryption library
 namespace FV {
@@ -41,12 +42,14 @@ struct plaintextModulus<mpz_class> {
     return mpz_class("987654345678987654345678987654323456953");
   }
 };
+size_t word_size = 32;  // Bits per word of the evaluation key
 using gauss_struct = nfl::gaussian<uint16_t, uint64_t, 2>;
 using gauss_t = nfl::FastGaussianNoise<uint16_t, uint64_t, 2>;
-gauss_t fg_prng_sk(8.0, 128, 1 << 14);
-gauss_t fg_prng_evk(8.0, 128, 1 << 14);
-gauss_t fg_prng_pk(8.0, 128, 1 << 14);
-gauss_t fg_prng_enc(8.0, 128, 1 << 14);
+// Built on first use; they share the table, each has its own stream
+FV::util::shared_noise fg_prng_sk(8.0);
+FV::util::shared_noise fg_prng_evk(8.0);
+FV::util::shared_noise fg_prng_pk(8.0);
+FV::util::shared_noise fg_prng_enc(8.0);
 }
 }  // namespace FV::params
 #include "FV.hpp"
@@ -57,7 +60,7 @@ int main() {
 
   // Keygen
   FV::sk_t secret_key;
-  FV::evk_t evaluation_key(secret_key, 32);
+  FV::evk_t evaluation_key(secret_key, FV::params::word_size);
   FV::pk_t public_key(secret_key, evaluation_key);
 
   // Polynomials
@@ -2,21 +2,22 @@
 #include <fstream>
 #include <iterator>
 #include <nfl.hpp>
-#include <chrono>
+#include <string>
 #include "tools.h" // Archivo con funciones para agilizar los tests
+#include "benchmark.h" // Arnés de medida: calentamiento, iteraciones y estadísticos
 
 #define N_POLINOMIOS 10 // En cada test creamos 10 polinomios
-#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
 
 #define CSV_FILE "statistics.csv"
+#define CSV_RESUMEN "statistics_resumen.csv"
 #define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
 
 template<size_t degree, size_t modulus, class T>
-void run_poly(int n_test) {
+void run_poly() {
 
     // Definir el tipo de polinomio (parámetros: grado y tamaño q)
     using poly_t = nfl::poly_from_modulus<T, degree, modulus>;
-    std::chrono::high_resolution_clock::time_point start, finish;
+    bench::harness h({"T_polinomio", "T_NTT", "T_suma", "T_multiplicacion", "T_INTT"});
 
     // Creamos un array de n Repeticiones alineado 32 bytes para asegurar el funcionamiento de AVX y SSE
     poly_t *polinomio_a = alloc_aligned<poly_t, 32>(N_POLINOMIOS), // Polinomio original sobre el que se van a hacer las operaciones básicas
@@ -28,70 +29,63 @@ void run_poly(int n_test) {
         printf("Error: Puntero no aineado\n");
         exit(1);
     }
-    // Inicializamos los array a ceros
-    std::fill(polinomio_a, polinomio_a + N_POLINOMIOS, 0);
-    std::fill(polinomio_b, polinomio_b + N_POLINOMIOS, 0);
-    std::fill(polinomio_c, polinomio_c + N_POLINOMIOS, 0);
+    while (h.siguiente()) {
+        // Inicializamos los array a ceros
+        std::fill(polinomio_a, polinomio_a + N_POLINOMIOS, 0);
+        std::fill(polinomio_b, polinomio_b + N_POLINOMIOS, 0);
+        std::fill(polinomio_c, polinomio_c + N_POLINOMIOS, 0);
 
-    // Test 1: Tiempo de creación de polinomios
-    start = std::chrono::high_resolution_clock::now();
-    std::fill(polinomio_a, polinomio_a + N_POLINOMIOS, nfl::uniform());
-    std::fill(polinomio_b, polinomio_b + N_POLINOMIOS, nfl::uniform());
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_polinomio = get_time_us(start, finish, 2*N_POLINOMIOS);
+        // Test 1: Tiempo de creación de polinomios
+        h.start("T_polinomio");
+        std::fill(polinomio_a, polinomio_a + N_POLINOMIOS, nfl::uniform());
+        std::fill(polinomio_b, polinomio_b + N_POLINOMIOS, nfl::uniform());
+        h.stop("T_polinomio", 2*N_POLINOMIOS);
     
-    // Test 2: Transformada directa NTT
-    start = std::chrono::high_resolution_clock::now();
-    for(int i = 0; i <N_POLINOMIOS; i++){
-        polinomio_a[i].ntt_pow_phi();
-        polinomio_b[i].ntt_pow_phi();
-    }
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_ntt = get_time_us(start, finish, 2*N_POLINOMIOS); // Multiplico por 2 porque estamos haciendo dos transformadas de a y b
+        // Test 2: Transformada directa NTT
+        h.start("T_NTT");
+        for(int i = 0; i <N_POLINOMIOS; i++){
+            polinomio_a[i].ntt_pow_phi();
+            polinomio_b[i].ntt_pow_phi();
+        }
+        h.stop("T_NTT", 2*N_POLINOMIOS); // Multiplico por 2 porque estamos haciendo dos transformadas de a y b
 
-    // Test 3: Suma NTT
-    start = std::chrono::high_resolution_clock::now();
-    for(int i = 0; i <N_POLINOMIOS; i++){
-        polinomio_c[i] = polinomio_a[i] + polinomio_b[i];
-    }
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_suma = get_time_us(start, finish, N_POLINOMIOS);
+        // Test 3: Suma NTT
+        h.start("T_suma");
+        for(int i = 0; i <N_POLINOMIOS; i++){
+            polinomio_c[i] = polinomio_a[i] + polinomio_b[i];
+        }
+        h.stop("T_suma", N_POLINOMIOS);
 
-    // Test 4: Multiplicación NTT
-    start = std::chrono::high_resolution_clock::now();
-    for(int i = 0; i <N_POLINOMIOS; i++){
-        polinomio_c[i] = polinomio_a[i] * polinomio_b[i];
-    }
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_multiplicacion = get_time_us(start, finish, N_POLINOMIOS);
+        // Test 4: Multiplicación NTT
+        h.start("T_multiplicacion");
+        for(int i = 0; i <N_POLINOMIOS; i++){
+            polinomio_c[i] = polinomio_a[i] * polinomio_b[i];
+        }
+        h.stop("T_multiplicacion", N_POLINOMIOS);
 
-    // Test 5: Transformada inversa NTT
-    start = std::chrono::high_resolution_clock::now();
-    for(int i = 0; i <N_POLINOMIOS; i++){
-        polinomio_a[i].invntt_pow_invphi();
-        polinomio_b[i].invntt_pow_invphi();
+        // Test 5: Transformada inversa NTT
+        h.start("T_INTT");
+        for(int i = 0; i <N_POLINOMIOS; i++){
+            polinomio_a[i].invntt_pow_invphi();
+            polinomio_b[i].invntt_pow_invphi();
+        }
+        h.stop("T_INTT", 2*N_POLINOMIOS);
     }
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_intt = get_time_us(start, finish, 2*N_POLINOMIOS);
 
     // Fin: Escribe resultados en csv
-    std::ofstream datos_csv;
-    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
-    datos_csv << LIBRERIA << "," << n_test << "," << modulus << "," << tiempo_polinomio << "," << tiempo_ntt << "," << tiempo_suma << "," << tiempo_multiplicacion << "," << tiempo_intt << "\n";
-    datos_csv.close();
-    
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(modulus));
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(modulus));
+
     // Libero el espacio reservado
-    free_aligned(REPETICIONES, polinomio_a);
-    free_aligned(REPETICIONES, polinomio_b);
-    free_aligned(REPETICIONES, polinomio_c);
+    free_aligned(N_POLINOMIOS, polinomio_a);
+    free_aligned(N_POLINOMIOS, polinomio_b);
+    free_aligned(N_POLINOMIOS, polinomio_c);
 }
 
 int main(){
     // Ejecutamos los test para los tres tamaños
-    for (int i=0; i< REPETICIONES; i++){
-        run_poly<256, 14, uint16_t>(i);
-        run_poly<256, 30, uint32_t>(i);
-        run_poly<256, 62, uint64_t>(i);
-    }
+    run_poly<256, 14, uint16_t>();
+    run_poly<256, 30, uint32_t>();
+    run_poly<256, 62, uint64_t>();
 
 }
\ No newline at end of file
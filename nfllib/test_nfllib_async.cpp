@@ -0,0 +1,145 @@
+// API asíncrona de FV (FV_async.hpp) frente a la síncrona en un servicio que
+// mezcla E/S y cálculo. Cada petición se recibe (latencia de red simulada),
+// se cifran dos mensajes, se multiplican, se descifra el resultado y se envía
+// (otra vez la latencia). Con la API síncrona todo va seguido en un hilo; con
+// la asíncrona el hilo principal recibe y encola las operaciones en el
+// executor, y otro hilo espera los resultados y los envía, así que la E/S se
+// solapa con el cálculo. Se mide peticiones por segundo con 1, 2, 4... hilos.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tools.h"
+#include "fv_params.hpp"
+#include "FV_async.hpp"
+
+#define N_PETICIONES 32 // Peticiones por medida
+#define LATENCIA_IO_US 10000 // Latencia simulada de red al recibir y al enviar
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "async.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+void esperar_red() {
+    std::this_thread::sleep_for(std::chrono::microseconds(LATENCIA_IO_US));
+}
+
+// Síncrono: recibir, cifrar, multiplicar, descifrar y enviar, una tras otra
+bool servir_sincrono(FV::sk_t const& secret_key, FV::pk_t const& public_key,
+                     std::vector<FV::mess_t> const& a, std::vector<FV::mess_t> const& b) {
+    bool correcto = true;
+    for (size_t r = 0; r < a.size(); r++) {
+        esperar_red();
+        FV::ciphertext_t ca, cb;
+        FV::encrypt(ca, public_key, a[r]);
+        FV::encrypt(cb, public_key, b[r]);
+        FV::ciphertext_t producto = ca * cb;
+        FV::mess_t resultado;
+        FV::decrypt(resultado, secret_key, public_key, producto);
+        esperar_red();
+        correcto = correcto && resultado.getValue() == (a[r] * b[r]).getValue();
+    }
+    return correcto;
+}
+
+// Asíncrono: el hilo principal recibe y encola, otro hilo espera y envía
+bool servir_asincrono(FV::async::executor &ex, FV::sk_t const& secret_key, FV::pk_t const& public_key,
+                      std::vector<FV::mess_t> const& a, std::vector<FV::mess_t> const& b) {
+    std::deque<std::shared_future<FV::mess_t>> pendientes;
+    std::mutex mutex;
+    std::condition_variable hay_pendientes;
+    bool correcto = true;
+
+    std::thread envio([&] {
+        for (size_t r = 0; r < a.size(); r++) {
+            std::shared_future<FV::mess_t> resultado;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                hay_pendientes.wait(lock, [&] { return !pendientes.empty(); });
+                resultado = pendientes.front();
+                pendientes.pop_front();
+            }
+            correcto = correcto && resultado.get().getValue() == (a[r] * b[r]).getValue();
+            esperar_red();
+        }
+    });
+
+    for (size_t r = 0; r < a.size(); r++) {
+        esperar_red();
+        auto ca = FV::async::encrypt(ex, public_key, a[r]);
+        auto cb = FV::async::encrypt(ex, public_key, b[r]);
+        auto producto = FV::async::multiply(ex, ca, cb);
+        auto resultado = FV::async::decrypt(ex, secret_key, public_key, producto);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendientes.push_back(resultado);
+        }
+        hay_pendientes.notify_one();
+    }
+    envio.join();
+    return correcto;
+}
+
+void escribir(std::ofstream &datos_csv, int n_test, char const* modo, size_t n_hilos, double peticiones_por_s) {
+    datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << modo << "," << n_hilos << "," << peticiones_por_s << "\n";
+    if (n_test == 0) {
+        std::cout << modo << " (" << n_hilos << " hilos): " << peticiones_por_s << " peticiones/s" << std::endl;
+    }
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    FV::context_t contexto;
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+
+    std::vector<FV::mess_t> a(N_PETICIONES), b(N_PETICIONES);
+    for (int r = 0; r < N_PETICIONES; r++) {
+        a[r].random();
+        b[r].random();
+    }
+
+    // Número de hilos: 1, 2, 4, ... hasta los hilos hardware
+    std::vector<size_t> hilos;
+    size_t maximo = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    for (size_t h = 1; h < maximo; h *= 2) {
+        hilos.push_back(h);
+    }
+    hilos.push_back(maximo);
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+        std::chrono::high_resolution_clock::time_point start, finish;
+
+        start = std::chrono::high_resolution_clock::now();
+        bool correcto = servir_sincrono(secret_key, public_key, a, b);
+        finish = std::chrono::high_resolution_clock::now();
+        if (!correcto) {
+            std::cout << "Error: resultado mal descifrado (síncrono)\n";
+            return 1;
+        }
+        escribir(datos_csv, n_test, "sincrono", 1, N_PETICIONES * 1e6 / get_time_us(start, finish, 1));
+
+        for (size_t n_hilos : hilos) {
+            FV::async::executor ex(contexto, n_hilos);
+            start = std::chrono::high_resolution_clock::now();
+            correcto = servir_asincrono(ex, secret_key, public_key, a, b);
+            finish = std::chrono::high_resolution_clock::now();
+            if (!correcto) {
+                std::cout << "Error: resultado mal descifrado (asíncrono)\n";
+                return 1;
+            }
+            escribir(datos_csv, n_test, "asincrono", n_hilos, N_PETICIONES * 1e6 / get_time_us(start, finish, 1));
+        }
+    }
+    datos_csv.close();
+}
@@ -0,0 +1,18 @@
+// FV (NFLlib) en el benchmark común de include/backend.h: las mismas fases y la
+// misma carga que test_openfhe_backend y test_helib_backend. El nivel de
+// seguridad se fija en compilación (-DSEC_LEVEL, ver fv_params.hpp).
+
+#include <exception>
+#include <iostream>
+#include "tools.h"
+#include "backend.h"
+#include "backend_nfllib.hpp"
+
+int main() {
+    try {
+        return bench::ejecutar_backend<backend_nfllib>(SEC_LEVEL);
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
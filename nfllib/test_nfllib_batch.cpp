@@ -0,0 +1,111 @@
+// Cifrado y descifrado por lotes (FV_batch.hpp): criptogramas por segundo en
+// función del número de hilos. Con la misma semilla el lote cifrado debe ser
+// idéntico sea cual sea el número de hilos, y descifrar a los mensajes.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include "tools.h"
+#include "fv_params.hpp"
+#include "FV_batch.hpp"
+
+#define N_CIFRADOS 256 // Criptogramas por lote
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "batch.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+using P = FV::params::poly_p;
+
+bool iguales(P const& a, P const& b) {
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        for (size_t k = 0; k < P::degree; k++) {
+            if (a(cm, k) != b(cm, k)) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+    // Se reutiliza solo para cifrar los mismos mensajes; con mensajes distintos
+    // la misma semilla filtraría su diferencia (FV_batch.hpp)
+    FV::prng::seed_t semilla = FV::prng::fresh_seed();
+
+    // Mensajes distintos para cada criptograma
+    std::vector<P> mensajes(N_CIFRADOS);
+    for (int i = 0; i < N_CIFRADOS; i++) {
+        mensajes[i] = {(uint64_t)i,2345,65222,44,5913,65505,65,1987,65520,20};
+    }
+    std::vector<std::array<mpz_t, N_COEF>> descifrados(N_CIFRADOS);
+    for (auto &poly : descifrados) {
+        for (size_t k = 0; k < N_COEF; k++) {
+            mpz_init(poly[k]);
+        }
+    }
+
+    // Número de hilos: 1, 2, 4, ... hasta los hilos hardware
+    std::vector<size_t> hilos;
+    size_t maximo = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    for (size_t h = 1; h < maximo; h *= 2) {
+        hilos.push_back(h);
+    }
+    hilos.push_back(maximo);
+
+    std::vector<FV::ciphertext_t> referencia;
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (size_t n_hilos : hilos) {
+        FV::util::thread_pool pool(n_hilos);
+        for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+            std::chrono::high_resolution_clock::time_point start, finish;
+            std::vector<P> m = mensajes;
+            std::vector<FV::ciphertext_t> cifrados(N_CIFRADOS);
+
+            // Test 1: Cifrado del lote
+            start = std::chrono::high_resolution_clock::now();
+            FV::encrypt_batch_reproducible(cifrados.data(), m.data(), N_CIFRADOS, public_key, semilla, pool);
+            finish = std::chrono::high_resolution_clock::now();
+            double cifrados_por_s = N_CIFRADOS * 1e6 / get_time_us(start, finish, 1);
+
+            // Test 2: Descifrado del lote
+            start = std::chrono::high_resolution_clock::now();
+            FV::decrypt_batch(descifrados.data(), cifrados.data(), N_CIFRADOS, secret_key, public_key, pool);
+            finish = std::chrono::high_resolution_clock::now();
+            double descifrados_por_s = N_CIFRADOS * 1e6 / get_time_us(start, finish, 1);
+
+            // Comprobación: mismo lote que con un hilo y descifrado correcto
+            if (referencia.empty()) {
+                referencia = cifrados;
+            }
+            bool correcto = true;
+            for (int i = 0; i < N_CIFRADOS && correcto; i++) {
+                correcto = iguales(cifrados[i].c0, referencia[i].c0) && iguales(cifrados[i].c1, referencia[i].c1) &&
+                           mpz_cmp_ui(descifrados[i][0], i) == 0 && mpz_cmp_ui(descifrados[i][9], 20) == 0;
+            }
+            if (!correcto) {
+                std::cout << "Error: el lote con " << n_hilos << " hilos no coincide\n";
+                return 1;
+            }
+
+            if (n_test == 0) {
+                std::cout << n_hilos << " hilos: " << cifrados_por_s << " cifrados/s, " << descifrados_por_s << " descifrados/s" << std::endl;
+            }
+            datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << n_hilos << "," << cifrados_por_s << "," << descifrados_por_s << "\n";
+        }
+    }
+    datos_csv.close();
+
+    for (auto &poly : descifrados) {
+        for (size_t k = 0; k < N_COEF; k++) {
+            mpz_clear(poly[k]);
+        }
+    }
+}
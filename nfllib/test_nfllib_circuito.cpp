@@ -0,0 +1,163 @@
+// Circuitos anchos de FV ejecutados como grafos de operaciones (circuito.h)
+// en serie y con robo de trabajo sobre 2, 4... hilos:
+//   arbol_suma      suma de N_HOJAS_SUMA criptogramas en árbol
+//   arbol_producto  producto de N_HOJAS_PRODUCTO criptogramas en árbol
+//   matriz          producto de dos matrices cifradas DIM x DIM
+// Se mide el tiempo de cada ejecución, la aceleración frente a la serie y el
+// máximo de criptogramas intermedios vivos a la vez, y se comprueba que las
+// salidas descifran bien.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tools.h"
+#include "circuito.h"
+#include "fv_params.hpp"
+
+#define N_HOJAS_SUMA 64 // Sumandos del árbol de sumas
+#define N_HOJAS_PRODUCTO 16 // Factores del árbol de productos (profundidad 4)
+#define DIM 4 // Dimensión de las matrices
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "circuito.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+using circuito_fv = circuito<FV::ciphertext_t>;
+
+FV::ciphertext_t sumar(FV::ciphertext_t const& a, FV::ciphertext_t const& b) { return a + b; }
+FV::ciphertext_t multiplicar(FV::ciphertext_t const& a, FV::ciphertext_t const& b) { return a * b; }
+
+// Un circuito con sus salidas y el mensaje que debe salir en cada una
+struct prueba {
+    std::string nombre;
+    circuito_fv circuito;
+    std::vector<circuito_fv::nodo_id> salidas;
+    std::vector<FV::mess_t> esperados;
+};
+
+// Reduce los nodos en árbol con op y devuelve la raíz
+circuito_fv::nodo_id arbol(circuito_fv &c, std::vector<circuito_fv::nodo_id> nivel, circuito_fv::operacion op) {
+    while (nivel.size() > 1) {
+        std::vector<circuito_fv::nodo_id> siguiente;
+        for (size_t i = 0; i + 1 < nivel.size(); i += 2) {
+            siguiente.push_back(c.operar(op, nivel[i], nivel[i + 1]));
+        }
+        if (nivel.size() % 2 == 1) {
+            siguiente.push_back(nivel.back());
+        }
+        nivel = siguiente;
+    }
+    return nivel[0];
+}
+
+FV::ciphertext_t cifrar(FV::pk_t const& public_key, FV::mess_t const& mensaje) {
+    FV::ciphertext_t cifrado;
+    FV::encrypt(cifrado, public_key, mensaje);
+    return cifrado;
+}
+
+void construir_arbol(prueba &p, FV::pk_t const& public_key, size_t hojas, bool producto) {
+    std::vector<circuito_fv::nodo_id> nodos;
+    FV::mess_t esperado(producto ? 1 : 0);
+    for (size_t i = 0; i < hojas; i++) {
+        FV::mess_t mensaje;
+        mensaje.random();
+        nodos.push_back(p.circuito.entrada(cifrar(public_key, mensaje)));
+        esperado = producto ? esperado * mensaje : esperado + mensaje;
+    }
+    p.salidas.push_back(arbol(p.circuito, nodos, producto ? multiplicar : sumar));
+    p.esperados.push_back(esperado);
+}
+
+void construir_matriz(prueba &p, FV::pk_t const& public_key) {
+    FV::mess_t a[DIM][DIM], b[DIM][DIM];
+    circuito_fv::nodo_id ca[DIM][DIM], cb[DIM][DIM];
+    for (int i = 0; i < DIM; i++) {
+        for (int j = 0; j < DIM; j++) {
+            a[i][j].random();
+            b[i][j].random();
+            ca[i][j] = p.circuito.entrada(cifrar(public_key, a[i][j]));
+            cb[i][j] = p.circuito.entrada(cifrar(public_key, b[i][j]));
+        }
+    }
+    for (int i = 0; i < DIM; i++) {
+        for (int j = 0; j < DIM; j++) {
+            std::vector<circuito_fv::nodo_id> productos;
+            FV::mess_t esperado(0);
+            for (int k = 0; k < DIM; k++) {
+                productos.push_back(p.circuito.operar(multiplicar, ca[i][k], cb[k][j]));
+                esperado = esperado + a[i][k] * b[k][j];
+            }
+            p.salidas.push_back(arbol(p.circuito, productos, sumar));
+            p.esperados.push_back(esperado);
+        }
+    }
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+
+    std::vector<prueba> pruebas(3);
+    pruebas[0].nombre = "arbol_suma";
+    construir_arbol(pruebas[0], public_key, N_HOJAS_SUMA, false);
+    pruebas[1].nombre = "arbol_producto";
+    construir_arbol(pruebas[1], public_key, N_HOJAS_PRODUCTO, true);
+    pruebas[2].nombre = "matriz";
+    construir_matriz(pruebas[2], public_key);
+    for (prueba &p : pruebas) {
+        for (circuito_fv::nodo_id s : p.salidas) {
+            p.circuito.salida(s);
+        }
+    }
+
+    // Número de hilos: 1 (serie), 2, 4, ... hasta los hilos hardware
+    std::vector<size_t> hilos;
+    size_t maximo = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    for (size_t h = 1; h < maximo; h *= 2) {
+        hilos.push_back(h);
+    }
+    hilos.push_back(maximo);
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+        for (prueba &p : pruebas) {
+            double tiempo_serie = 0;
+            for (size_t n_hilos : hilos) {
+                std::chrono::high_resolution_clock::time_point start, finish;
+                start = std::chrono::high_resolution_clock::now();
+                p.circuito.ejecutar(n_hilos);
+                finish = std::chrono::high_resolution_clock::now();
+                double tiempo = get_time_us(start, finish, 1);
+                if (n_hilos == 1) {
+                    tiempo_serie = tiempo;
+                }
+
+                for (size_t s = 0; s < p.salidas.size(); s++) {
+                    FV::mess_t resultado;
+                    FV::decrypt(resultado, secret_key, public_key, p.circuito.valor(p.salidas[s]));
+                    if (resultado.getValue() != p.esperados[s].getValue()) {
+                        std::cout << "Error: " << p.nombre << " con " << n_hilos << " hilos no descifra bien\n";
+                        return 1;
+                    }
+                }
+
+                if (n_test == 0) {
+                    std::cout << p.nombre << " (" << p.circuito.operaciones() << " operaciones, " << n_hilos << " hilos): " << tiempo
+                              << " us, aceleración " << tiempo_serie / tiempo << ", pico de intermedios " << p.circuito.pico_vivos() << std::endl;
+                }
+                datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << p.nombre << "," << n_hilos << ","
+                          << tiempo << "," << tiempo_serie / tiempo << "," << p.circuito.pico_vivos() << "\n";
+            }
+        }
+    }
+    datos_csv.close();
+}
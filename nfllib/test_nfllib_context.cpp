@@ -0,0 +1,116 @@
+// Prueba de estrés de FV con varios hilos (FV_context.hpp): cada hilo saca su
+// propio worker del contexto y cifra mensajes aleatorios con las mismas
+// claves, sin cerrojos. Se mide el cifrado por segundo con 1, 2, 4... hilos y
+// la eficiencia frente al escalado lineal. Los hilos se crean y preparan sus
+// mensajes antes de empezar a medir (medir_rendimiento, rendimiento.h) y los
+// criptogramas se descifran y se comprueban después, fuera de la medida. Antes
+// del barrido se hace una ronda con un hilo que no se mide, para que el
+// primer uso (fallos de página, tablas) no caiga en la base de la eficiencia.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <array>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "tools.h"
+#include "rendimiento.h"
+#include "fv_params.hpp"
+#include "FV_context.hpp"
+
+#define N_CIFRADOS 64 // Criptogramas por hilo
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "context.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+// Estado de un hilo: su worker, los mensajes y sus criptogramas
+struct flujo {
+    explicit flujo(FV::context_t::worker_t w) : worker(std::move(w)), mensajes(N_CIFRADOS) {
+        for (FV::mess_t& mensaje : mensajes) {
+            mensaje.random(worker.rng);
+        }
+        cifrados.reserve(N_CIFRADOS);
+    }
+
+    FV::context_t::worker_t worker;
+    std::vector<FV::mess_t> mensajes;
+    std::vector<FV::ciphertext_t> cifrados;
+};
+
+// El worker está alineado a 64 bytes y new no lo respeta en C++11: los flujos
+// se reservan con alloc_aligned (tools.h)
+struct liberar_flujo {
+    void operator()(flujo* f) const { free_aligned(1, f); }
+};
+using flujo_ptr = std::unique_ptr<flujo, liberar_flujo>;
+
+// Descifra los criptogramas de los hilos y cuenta los que no coinciden con su mensaje
+int comprobar(std::vector<flujo_ptr> const& flujos, FV::sk_t const& secret_key, FV::pk_t const& public_key) {
+    std::array<mpz_t, N_COEF> plaintext;
+    for (size_t k = 0; k < N_COEF; k++) {
+        mpz_init(plaintext[k]);
+    }
+    int errores = 0;
+    for (flujo_ptr const& f : flujos) {
+        for (size_t i = 0; i < f->cifrados.size(); i++) {
+            FV::decrypt_poly(plaintext, secret_key, public_key, f->cifrados[i]);
+            if (mpz_class(plaintext[0]) != f->mensajes[i].getValue()) {
+                errores++;
+            }
+        }
+    }
+    for (size_t k = 0; k < N_COEF; k++) {
+        mpz_clear(plaintext[k]);
+    }
+    return errores;
+}
+
+int main() {
+    FV::context_t contexto;
+    FV::context_t::worker_t principal = contexto.fork();
+    FV::sk_t secret_key = FV::make_sk(principal);
+    std::unique_ptr<FV::evk_t> evaluation_key = FV::make_evk(principal, secret_key, FV::params::word_size);
+    std::unique_ptr<FV::pk_t> public_key = FV::make_pk(principal, secret_key, *evaluation_key);
+
+    // Cifra N_CIFRADOS mensajes en cada hilo; los flujos quedan en flujos para comprobarlos
+    std::vector<flujo_ptr> flujos;
+    auto cifrar = [&](size_t n_hilos) {
+        flujos.clear();
+        flujos.resize(n_hilos);
+        return bench::medir_rendimiento(n_hilos, N_CIFRADOS, [&](size_t h) {
+            flujos[h].reset(alloc_aligned<flujo, alignof(flujo)>(1, contexto.fork()));
+            flujo* f = flujos[h].get();
+            return [f, &public_key]() {
+                FV::params::poly_p poly_m{f->mensajes[f->cifrados.size()].getValue()};
+                f->cifrados.emplace_back();
+                FV::encrypt_poly(f->cifrados.back(), *public_key, poly_m, f->worker);
+            };
+        });
+    };
+    cifrar(1); // Calentamiento
+
+    double cifrados_por_s_1 = 0;
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (size_t n_hilos : bench::hilos_hasta_nucleos()) {
+        for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+            double cifrados_por_s = cifrar(n_hilos).peticiones_por_s;
+            int errores = comprobar(flujos, secret_key, *public_key);
+            if (errores != 0) {
+                std::cout << "Error: " << errores << " mensajes mal descifrados con " << n_hilos << " hilos\n";
+                return 1;
+            }
+
+            if (n_hilos == 1 && n_test == 0) {
+                cifrados_por_s_1 = cifrados_por_s;
+            }
+            double eficiencia = cifrados_por_s / (n_hilos * cifrados_por_s_1);
+            if (n_test == 0) {
+                std::cout << n_hilos << " hilos: " << cifrados_por_s << " cifrados/s, eficiencia " << eficiencia << std::endl;
+            }
+            datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << n_hilos << "," << cifrados_por_s << "," << eficiencia << "\n";
+        }
+    }
+    datos_csv.close();
+}
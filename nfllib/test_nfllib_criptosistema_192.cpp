@@ -1,19 +1,24 @@
 // Se parte del ejemplo disponible en https://github.com/quarkslab/NFLlib
 
 #include <cstddef>
+#include <cstdio>
 #include <gmpxx.h>
-#include <chrono>
 #include <iostream>
 #include <nfl.hpp>
 #include <thread>
 #include <vector>
 #include <fstream>
+#include <string>
 #include "tools.h"
+#include "benchmark.h"
+#include "FV_noise.hpp"
 
 #define N_COEF 16 // Coeficiente de los polinomios y grado del polinomio
-#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
 #define CSV_FILE "he_schemes.csv"
+#define CSV_RESUMEN "he_schemes_resumen.csv"
+#define CSV_TAMANOS "tamanos.csv"
 #define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+#define ESQUEMA "FV" // Columna Esquema de los CSV (OpenFHE tiene varios)
 #define SEC_LEVEL 192
 #define MODULUS_Q 573 // Es el parámetro para seguridad 256 definido por el homomorphic standard
 
@@ -29,123 +34,157 @@ struct plaintextModulus<mpz_class> {
     return mpz_class("65537");
   }
 };
+size_t word_size = 32; // Bits por palabra de la clave de evaluación
 using gauss_struct = nfl::gaussian<uint16_t, uint64_t, 2>;
 using gauss_t = nfl::FastGaussianNoise<uint16_t, uint64_t, 2>;
-gauss_t fg_prng_sk(8.0, 128, 1 << 14);
-gauss_t fg_prng_evk(8.0, 128, 1 << 14);
-gauss_t fg_prng_pk(8.0, 128, 1 << 14);
-gauss_t fg_prng_enc(8.0, 128, 1 << 14);
+// Se construyen al usarse por primera vez; comparten solo la tabla y cada uno
+// tiene su propio flujo
+FV::util::shared_noise fg_prng_sk(8.0);
+FV::util::shared_noise fg_prng_evk(8.0);
+FV::util::shared_noise fg_prng_pk(8.0);
+FV::util::shared_noise fg_prng_enc(8.0);
 }
 }  // namespace FV::params
 #include "FV.hpp"
+#include "FV_io.hpp"
 
-int run_bfv(int n_test, int security_level) {
-    // Semilla para valores deterministas
-    srand(0);
-    std::chrono::high_resolution_clock::time_point start, finish;
-    // Creo los polinomios que voy a multiplicar
-    FV::params::poly_p polinomios[3];
-    
-    polinomios[0] = {12,2345,65222,44,5913,65505,65,1987,65520,20,0,0,0,0,0,0}; // a
-    polinomios[1] = {11,3690,65535,35,8765,65490,89,9012,65530,10,0,0,0,0,0,0}; // b
-    polinomios[2] = {5,4321,65100,23,6789,65495,88,1024,65200,95,0,0,0,0,0,0};  // c
-
-    // Test 1: Generación de claves
-    start = std::chrono::high_resolution_clock::now();
-    FV::sk_t secret_key;
-    FV::evk_t evaluation_key(secret_key, 32);
-    FV::pk_t public_key(secret_key, evaluation_key);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_keygen = get_time_us(start, finish, 1);
-
-    // Test 2: Cifrado
-    start = std::chrono::high_resolution_clock::now();
-    std::array<FV::ciphertext_t, 3> texto_cifrado;
-    FV::encrypt_poly(texto_cifrado[0], public_key, polinomios[0]);
-    FV::encrypt_poly(texto_cifrado[1], public_key, polinomios[1]);
-    FV::encrypt_poly(texto_cifrado[2], public_key, polinomios[2]);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_cifrado = get_time_us(start, finish, 3);
-
-    // Test 3: Suma a+b+c
-    start = std::chrono::high_resolution_clock::now();
-    FV::ciphertext_t suma_abc = texto_cifrado[0] + texto_cifrado[1];
-    suma_abc = suma_abc + texto_cifrado[2];
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_suma = get_time_us(start, finish, 2);
-
-    // Test 4: Multiplicacion a*b*c
-    start = std::chrono::high_resolution_clock::now();
-    FV::ciphertext_t mul_abc = texto_cifrado[0] * texto_cifrado[1];
-    mul_abc = mul_abc * texto_cifrado[2];
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_mul = get_time_us(start, finish, 2);
-
-    // Inicializamos polinomios de descifrado
-    std::array<mpz_t, N_COEF> plaintext_suma, plaintext_mul;
+// Tamaño de las claves y de un criptograma serializados con FV_io.hpp (con la cabecera)
+void escribir_tamanos(FV::sk_t const& secret_key, FV::evk_t const& evaluation_key, FV::pk_t const& public_key,
+                      FV::ciphertext_t const& texto_cifrado, int security_level) {
+    char const* fichero = "tamano.fv";
+    std::string grupo = std::to_string(security_level);
+    FV::io::write(fichero, secret_key);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_secreta", FV::io::file_bytes(fichero));
+    FV::io::write(fichero, public_key);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_publica", FV::io::file_bytes(fichero));
+    FV::io::write(fichero, evaluation_key);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_evaluacion", FV::io::file_bytes(fichero));
+    FV::io::write(fichero, &texto_cifrado, 1);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "criptograma", FV::io::file_bytes(fichero));
+    std::remove(fichero);
+}
+
+int run_bfv(int security_level) {
+    bench::harness h({"T_keygen", "T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado", "T_context"});
+    // Codificación por coeficientes: cada coeficiente es una ranura, de las que a, b y c usan 10
+    h.carga(h.llenar() ? N_COEF : 10, N_COEF, N_COEF, {"T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado"});
+    while (h.siguiente()) {
+        // Semilla para valores deterministas
+        srand(0);
+        // Creo los polinomios que voy a multiplicar
+        FV::params::poly_p polinomios[3];
     
-    for (size_t i = 0; i < N_COEF; i++) {
-        mpz_inits(plaintext_suma[i], plaintext_mul[i], nullptr);
-    }
+        polinomios[0] = {12,2345,65222,44,5913,65505,65,1987,65520,20,0,0,0,0,0,0}; // a
+        polinomios[1] = {11,3690,65535,35,8765,65490,89,9012,65530,10,0,0,0,0,0,0}; // b
+        polinomios[2] = {5,4321,65100,23,6789,65495,88,1024,65200,95,0,0,0,0,0,0};  // c
+        if (h.llenar()) {
+            long t = FV::params::plaintextModulus<mpz_class>::value().get_si();
+            for (size_t k = 0; k < 3; k++) {
+                std::vector<int64_t> datos = bench::datos_aleatorios(N_COEF, t, k);
+                for (size_t cm = 0; cm < FV::params::poly_p::nmoduli; cm++) {
+                    for (size_t i = 0; i < N_COEF; i++) {
+                        polinomios[k](cm, i) = datos[i];
+                    }
+                }
+            }
+        }
+
+        // Test 1: Generación de claves
+        h.start("T_keygen");
+        FV::sk_t secret_key;
+        FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+        FV::pk_t public_key(secret_key, evaluation_key);
+        h.stop("T_keygen");
+
+        // Test 2: Cifrado
+        h.start("T_cifardo");
+        std::array<FV::ciphertext_t, 3> texto_cifrado;
+        FV::encrypt_poly(texto_cifrado[0], public_key, polinomios[0]);
+        FV::encrypt_poly(texto_cifrado[1], public_key, polinomios[1]);
+        FV::encrypt_poly(texto_cifrado[2], public_key, polinomios[2]);
+        h.stop("T_cifardo", 3);
+
+        // Test 3: Suma a+b+c
+        h.start("T_suma");
+        FV::ciphertext_t suma_abc = texto_cifrado[0] + texto_cifrado[1];
+        suma_abc = suma_abc + texto_cifrado[2];
+        h.stop("T_suma", 2);
+
+        // Test 4: Multiplicacion a*b*c
+        h.start("T_multiplicacion");
+        FV::ciphertext_t mul_abc = texto_cifrado[0] * texto_cifrado[1];
+        mul_abc = mul_abc * texto_cifrado[2];
+        h.stop("T_multiplicacion", 2);
+
+        // Inicializamos polinomios de descifrado
+        std::array<mpz_t, N_COEF> plaintext_suma, plaintext_mul;
     
-    // Test 5: Descifrado
-    start = std::chrono::high_resolution_clock::now();
-    FV::decrypt_poly(plaintext_suma, secret_key, public_key, suma_abc);
-    FV::decrypt_poly(plaintext_mul, secret_key, public_key, mul_abc);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_descifrado = get_time_us(start, finish, 2);
-
-    std::array<mpz_t, N_COEF> polinomio_a, polinomio_b, polinomio_c;
+        for (size_t i = 0; i < N_COEF; i++) {
+            mpz_inits(plaintext_suma[i], plaintext_mul[i], nullptr);
+        }
     
-    for (size_t i = 0; i < N_COEF; i++) {
-        mpz_inits(polinomio_a[i], polinomio_b[i], polinomio_c[i], nullptr);
-    }
+        // Test 5: Descifrado
+        h.start("T_descifrado");
+        FV::decrypt_poly(plaintext_suma, secret_key, public_key, suma_abc);
+        FV::decrypt_poly(plaintext_mul, secret_key, public_key, mul_abc);
+        h.stop("T_descifrado", 2);
+
+        if (h.primera()) {
+            escribir_tamanos(secret_key, evaluation_key, public_key, texto_cifrado[0], security_level);
+        }
+
+        // Se muestran los polinomios una vez
+        if (h.primera()) {
+            std::array<mpz_t, N_COEF> polinomio_a, polinomio_b, polinomio_c;
     
-    FV::decrypt_poly(polinomio_a, secret_key, public_key, texto_cifrado[0]);
-    FV::decrypt_poly(polinomio_b, secret_key, public_key, texto_cifrado[1]);
-    FV::decrypt_poly(polinomio_c, secret_key, public_key, texto_cifrado[2]);
+            for (size_t i = 0; i < N_COEF; i++) {
+                mpz_inits(polinomio_a[i], polinomio_b[i], polinomio_c[i], nullptr);
+            }
     
-    std::cout << "Polinomio a: [";
-    for (int i = 0; i < N_COEF; i++){
-        std::cout << mpz_class(polinomio_a[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
-    }
-    std::cout << "Polinomio b: [";
-    for (int i = 0; i < N_COEF; i++){
-        std::cout << mpz_class(polinomio_b[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
-    }
+            FV::decrypt_poly(polinomio_a, secret_key, public_key, texto_cifrado[0]);
+            FV::decrypt_poly(polinomio_b, secret_key, public_key, texto_cifrado[1]);
+            FV::decrypt_poly(polinomio_c, secret_key, public_key, texto_cifrado[2]);
     
-    std::cout << "Polinomio c: ["; 
-    for (int i = 0; i < N_COEF; i++){
-        std::cout << mpz_class(polinomio_c[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
-    }
-    std::cout << "a + b + c: [";
-    for (int i = 0; i < N_COEF; i++){
-        std::cout << mpz_class(plaintext_suma[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
-    }
-    std::cout << "a * b * c: [";
-    for (int i = 0; i < N_COEF; i++){
-        std::cout << mpz_class(plaintext_mul[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
-    }
+            std::cout << "Polinomio a: [";
+            for (int i = 0; i < N_COEF; i++){
+                std::cout << mpz_class(polinomio_a[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
+            }
+            std::cout << "Polinomio b: [";
+            for (int i = 0; i < N_COEF; i++){
+                std::cout << mpz_class(polinomio_b[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
+            }
     
-    for (size_t i = 0; i < N_COEF; i++) {
-        mpz_clear(polinomio_a[i]);
-        mpz_clear(polinomio_b[i]);
-        mpz_clear(polinomio_c[i]);
-        mpz_clear(plaintext_suma[i]);
-        mpz_clear(plaintext_mul[i]);
+            std::cout << "Polinomio c: ["; 
+            for (int i = 0; i < N_COEF; i++){
+                std::cout << mpz_class(polinomio_c[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
+            }
+            std::cout << "a + b + c: [";
+            for (int i = 0; i < N_COEF; i++){
+                std::cout << mpz_class(plaintext_suma[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
+            }
+            std::cout << "a * b * c: [";
+            for (int i = 0; i < N_COEF; i++){
+                std::cout << mpz_class(plaintext_mul[i]).get_str() << (i == N_COEF-1 ? "]\n" : ", ");
+            }
+
+            for (size_t i = 0; i < N_COEF; i++) {
+                mpz_clears(polinomio_a[i], polinomio_b[i], polinomio_c[i], nullptr);
+            }
+        }
+
+        for (size_t i = 0; i < N_COEF; i++) {
+            mpz_clear(plaintext_suma[i]);
+            mpz_clear(plaintext_mul[i]);
+        }
     }
-    
-    // Fin: Escribe resultados en csv
-    std::ofstream datos_csv;
-    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
-    datos_csv << LIBRERIA << "," << n_test << "," << security_level << "," << tiempo_keygen << "," << tiempo_cifrado << "," << tiempo_suma << "," << tiempo_mul << "," << tiempo_descifrado << "," << "\n"; //Pongo dos commas porque este no veo que inicialize contttexto
-    datos_csv.close();
+
+    // Fin: Escribe resultados en csv (este no inicializa contexto, T_context queda vacío)
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(security_level) + "," ESQUEMA);
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(security_level) + "," ESQUEMA);
 
     return 0;
 }
 
 int main(){
-    for (int i=0; i< REPETICIONES; i++){
-        run_bfv(i, SEC_LEVEL);
-    }
+    run_bfv(SEC_LEVEL);
 }
\ No newline at end of file
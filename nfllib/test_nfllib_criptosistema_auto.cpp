@@ -0,0 +1,176 @@
+// Mismo test que test_nfllib_criptosistema_128/192/256.cpp, pero con los
+// parámetros de fv_params.hpp. El objetivo nfllib_auto del Makefile lo compila
+// con el grado y el módulo que elige fv_select (FV_select.hpp) para la
+// profundidad del test (a*b*c, profundidad 2) en vez de los de HElib.
+// Escribe en he_schemes.csv como "nfllib_auto" y comprueba que a*b*c descifra
+// bien calculando el producto en claro.
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <gmpxx.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "tools.h"
+#include "benchmark.h"
+#include "fv_params.hpp"
+#include "FV_io.hpp"
+
+#define CSV_FILE "he_schemes.csv"
+#define CSV_RESUMEN "he_schemes_resumen.csv"
+#define CSV_TAMANOS "tamanos.csv"
+#define LIBRERIA "nfllib_auto" // Utilizada para saber a qué librería pertenece
+#define ESQUEMA "FV" // Columna Esquema de los CSV (OpenFHE tiene varios)
+#define N_MOSTRAR 16 // Coeficientes que se muestran de cada polinomio
+
+using P = FV::params::poly_p;
+
+// Coeficientes de a, b y c (el resto son 0, o todos aleatorios con BENCH_LLENAR)
+std::vector<long> coef_a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+std::vector<long> coef_b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+std::vector<long> coef_c = {5,4321,65100,23,6789,65495,88,1024,65200,95};
+
+// Producto en claro en Z_t[X]/(X^n + 1)
+std::vector<mpz_class> producto(std::vector<mpz_class> const& x, std::vector<long> const& y) {
+    mpz_class t = FV::params::plaintextModulus<mpz_class>::value();
+    std::vector<mpz_class> r(N_COEF, 0);
+    for (size_t i = 0; i < x.size(); i++) {
+        for (size_t j = 0; j < y.size(); j++) {
+            if (i + j < N_COEF) {
+                r[i + j] += x[i] * y[j];
+            } else {
+                r[i + j - N_COEF] -= x[i] * y[j];
+            }
+        }
+    }
+    for (mpz_class& c : r) {
+        c %= t;
+        if (c < 0) {
+            c += t;
+        }
+    }
+    return r;
+}
+
+P polinomio(std::vector<long> const& coef) {
+    P p;
+    p = 0;
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        for (size_t k = 0; k < coef.size(); k++) {
+            p(cm, k) = coef[k];
+        }
+    }
+    return p;
+}
+
+// Tamaño de las claves y de un criptograma serializados con FV_io.hpp (con la cabecera)
+void escribir_tamanos(FV::sk_t const& secret_key, FV::evk_t const& evaluation_key, FV::pk_t const& public_key,
+                      FV::ciphertext_t const& texto_cifrado, int security_level) {
+    char const* fichero = "tamano.fv";
+    std::string grupo = std::to_string(security_level);
+    FV::io::write(fichero, secret_key);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_secreta", FV::io::file_bytes(fichero));
+    FV::io::write(fichero, public_key);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_publica", FV::io::file_bytes(fichero));
+    FV::io::write(fichero, evaluation_key);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_evaluacion", FV::io::file_bytes(fichero));
+    FV::io::write(fichero, &texto_cifrado, 1);
+    memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "criptograma", FV::io::file_bytes(fichero));
+    std::remove(fichero);
+}
+
+int run_bfv(int security_level) {
+    bench::harness h({"T_keygen", "T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado", "T_context"});
+    // Codificación por coeficientes: cada coeficiente es una ranura
+    if (h.llenar()) {
+        long t = FV::params::plaintextModulus<mpz_class>::value().get_si();
+        std::vector<long>* coeficientes[3] = {&coef_a, &coef_b, &coef_c};
+        for (size_t k = 0; k < 3; k++) {
+            std::vector<int64_t> datos = bench::datos_aleatorios(N_COEF, t, k);
+            coeficientes[k]->assign(datos.begin(), datos.end());
+        }
+    }
+    h.carga(coef_a.size(), N_COEF, N_COEF, {"T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado"});
+    while (h.siguiente()) {
+        // Semilla para valores deterministas
+        srand(0);
+        P polinomios[3] = {polinomio(coef_a), polinomio(coef_b), polinomio(coef_c)};
+
+        // Test 1: Generación de claves
+        h.start("T_keygen");
+        FV::sk_t secret_key;
+        FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+        FV::pk_t public_key(secret_key, evaluation_key);
+        h.stop("T_keygen");
+
+        // Test 2: Cifrado
+        h.start("T_cifardo");
+        std::array<FV::ciphertext_t, 3> texto_cifrado;
+        FV::encrypt_poly(texto_cifrado[0], public_key, polinomios[0]);
+        FV::encrypt_poly(texto_cifrado[1], public_key, polinomios[1]);
+        FV::encrypt_poly(texto_cifrado[2], public_key, polinomios[2]);
+        h.stop("T_cifardo", 3);
+
+        // Test 3: Suma a+b+c
+        h.start("T_suma");
+        FV::ciphertext_t suma_abc = texto_cifrado[0] + texto_cifrado[1];
+        suma_abc = suma_abc + texto_cifrado[2];
+        h.stop("T_suma", 2);
+
+        // Test 4: Multiplicacion a*b*c
+        h.start("T_multiplicacion");
+        FV::ciphertext_t mul_abc = texto_cifrado[0] * texto_cifrado[1];
+        mul_abc = mul_abc * texto_cifrado[2];
+        h.stop("T_multiplicacion", 2);
+
+        // Inicializamos polinomios de descifrado
+        std::array<mpz_t, N_COEF> plaintext_suma, plaintext_mul;
+        for (size_t i = 0; i < N_COEF; i++) {
+            mpz_inits(plaintext_suma[i], plaintext_mul[i], nullptr);
+        }
+
+        // Test 5: Descifrado
+        h.start("T_descifrado");
+        FV::decrypt_poly(plaintext_suma, secret_key, public_key, suma_abc);
+        FV::decrypt_poly(plaintext_mul, secret_key, public_key, mul_abc);
+        h.stop("T_descifrado", 2);
+
+        if (h.primera()) {
+            escribir_tamanos(secret_key, evaluation_key, public_key, texto_cifrado[0], security_level);
+        }
+
+        // Comprobación de a*b*c con el producto en claro
+        std::vector<mpz_class> esperado(coef_a.begin(), coef_a.end());
+        esperado = producto(producto(esperado, coef_b), coef_c);
+        bool correcto = true;
+        for (size_t i = 0; i < N_COEF; i++) {
+            correcto = correcto && mpz_class(plaintext_mul[i]) == esperado[i];
+        }
+        if (h.primera()) {
+            std::cout << "N_COEF " << N_COEF << ", q de " << MODULUS_Q << " bits (" << P::nmoduli << " módulos)\n";
+            std::cout << "a * b * c: [";
+            for (int i = 0; i < N_MOSTRAR; i++){
+                std::cout << mpz_class(plaintext_mul[i]).get_str() << (i == N_MOSTRAR-1 ? ", ...]\n" : ", ");
+            }
+        }
+        for (size_t i = 0; i < N_COEF; i++) {
+            mpz_clears(plaintext_suma[i], plaintext_mul[i], nullptr);
+        }
+        if (!correcto) {
+            std::cout << "Error: a * b * c no descifra bien\n";
+            return 1;
+        }
+    }
+
+    // Fin: Escribe resultados en csv
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(security_level) + "," ESQUEMA);
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(security_level) + "," ESQUEMA);
+
+    return 0;
+}
+
+int main(){
+    return run_bfv(SEC_LEVEL);
+}
@@ -0,0 +1,128 @@
+// Lotes de criptogramas en disco (FV_io.hpp): se escribe un fichero más grande
+// que la memoria con ciphertext_writer, se mapea con ciphertext_file y se
+// evalúa sobre las vistas sin copiarlas (suma de cada par de criptogramas),
+// escribiendo el resultado en otro fichero. Se mide el caudal de escritura y
+// el de lectura + evaluación + escritura, y la multiplicación sobre vistas
+// frente a la de ciphertext_t.
+// Tamaño del fichero de entrada: el primer argumento en GiB o, sin argumentos,
+// 1.25 veces la memoria física (hace falta 1.5 veces eso libre en disco).
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include "tools.h"
+#include "fv_params.hpp"
+#include "FV_io.hpp"
+
+#define REPETICIONES 3 // Cada repetición escribe y recorre el fichero entero
+#define N_DISTINTOS 16 // Criptogramas distintos que se repiten en el fichero
+#define N_MUL 8 // Multiplicaciones por medida
+#define LIBERAR_CADA 64 // Criptogramas entre dos liberaciones de páginas
+#define CSV_FILE "ctfile.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+#define IN_FILE "fv_ct_entrada.bin"
+#define OUT_FILE "fv_ct_salida.bin"
+
+int main(int argc, char **argv) {
+    // Semilla para valores deterministas
+    srand(0);
+    size_t const bytes_cifrado = 2 * FV::io::poly_bytes;
+    double bytes_objetivo = argc > 1 ? std::atof(argv[1]) * (1 << 30)
+                                     : 1.25 * sysconf(_SC_PHYS_PAGES) * (double)sysconf(_SC_PAGE_SIZE);
+    size_t n_cifrados = 2 * (size_t)(bytes_objetivo / (2 * bytes_cifrado) + 1);
+
+    struct statvfs disco;
+    if (statvfs(".", &disco) == 0 && 1.5 * n_cifrados * bytes_cifrado > (double)disco.f_bavail * disco.f_frsize) {
+        std::cout << "Error: no hay espacio en disco para " << 1.5 * n_cifrados * bytes_cifrado / (1 << 30) << " GiB\n";
+        return 1;
+    }
+
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+
+    // Criptogramas de mensajes conocidos, que se repiten a lo largo del fichero
+    FV::mess_t mensajes[N_DISTINTOS];
+    FV::ciphertext_t cifrados[N_DISTINTOS];
+    for (int i = 0; i < N_DISTINTOS; i++) {
+        mensajes[i].random();
+        FV::encrypt(cifrados[i], public_key, mensajes[i]);
+    }
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+        std::chrono::high_resolution_clock::time_point start, finish;
+
+        // Test 1: Escritura del lote
+        start = std::chrono::high_resolution_clock::now();
+        FV::io::ciphertext_writer escritor(IN_FILE, n_cifrados);
+        for (size_t i = 0; i < n_cifrados; i++) {
+            escritor.append(cifrados[i % N_DISTINTOS]);
+        }
+        escritor.close();
+        finish = std::chrono::high_resolution_clock::now();
+        double bytes_fichero = FV::io::file_bytes(IN_FILE);
+        double mbs_escritura = bytes_fichero / get_time_us(start, finish, 1);
+
+        // Test 2: Lectura (mmap) + suma de cada par + escritura del resultado
+        FV::io::ciphertext_file entrada(IN_FILE, public_key);
+        start = std::chrono::high_resolution_clock::now();
+        FV::io::ciphertext_writer salida(OUT_FILE, n_cifrados / 2);
+        for (size_t i = 0; i < n_cifrados / 2; i++) {
+            salida.append(entrada[2 * i] + entrada[2 * i + 1]);
+            if ((2 * i + 2) % LIBERAR_CADA == 0) {
+                entrada.release(2 * i + 2 - LIBERAR_CADA, 2 * i + 2);
+            }
+        }
+        salida.close();
+        finish = std::chrono::high_resolution_clock::now();
+        double mbs_evaluacion = (bytes_fichero + FV::io::file_bytes(OUT_FILE)) / get_time_us(start, finish, 1);
+
+        // Test 3: Multiplicación sobre las vistas y sobre ciphertext_t
+        double tiempo_mul_vista = 0, tiempo_mul_ciphertext = 0;
+        FV::ciphertext_t producto_vista, producto;
+        for (int i = 0; i < N_MUL; i++) {
+            start = std::chrono::high_resolution_clock::now();
+            producto_vista = entrada[i] * entrada[i + 1];
+            finish = std::chrono::high_resolution_clock::now();
+            tiempo_mul_vista += get_time_us(start, finish, N_MUL);
+
+            FV::ciphertext_t a(entrada[i]), b(entrada[i + 1]);
+            start = std::chrono::high_resolution_clock::now();
+            producto = a * b;
+            finish = std::chrono::high_resolution_clock::now();
+            tiempo_mul_ciphertext += get_time_us(start, finish, N_MUL);
+        }
+
+        // Comprobación: la suma del último par y el último producto
+        FV::io::ciphertext_file resultado(OUT_FILE, public_key);
+        size_t ultimo = n_cifrados / 2 - 1;
+        FV::mess_t suma, mul;
+        FV::decrypt(suma, secret_key, public_key, FV::ciphertext_t(resultado[ultimo]));
+        FV::decrypt(mul, secret_key, public_key, producto_vista);
+        bool correcto = suma.getValue() == (mensajes[(2 * ultimo) % N_DISTINTOS] + mensajes[(2 * ultimo + 1) % N_DISTINTOS]).getValue() &&
+                        mul.getValue() == (mensajes[(N_MUL - 1) % N_DISTINTOS] * mensajes[N_MUL % N_DISTINTOS]).getValue();
+        if (!correcto) {
+            std::cout << "Error: el resultado no descifra bien\n";
+            return 1;
+        }
+
+        if (n_test == 0) {
+            std::cout << n_cifrados << " criptogramas, " << bytes_fichero / (1 << 30) << " GiB: escritura " << mbs_escritura
+                      << " MB/s, lectura + suma + escritura " << mbs_evaluacion << " MB/s, multiplicación " << tiempo_mul_vista
+                      << " us (vistas) / " << tiempo_mul_ciphertext << " us (ciphertext_t)" << std::endl;
+        }
+        datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << n_cifrados << "," << (size_t)bytes_fichero << ","
+                  << mbs_escritura << "," << mbs_evaluacion << "," << tiempo_mul_vista << "," << tiempo_mul_ciphertext << "\n";
+    }
+    datos_csv.close();
+    std::remove(IN_FILE);
+    std::remove(OUT_FILE);
+}
@@ -0,0 +1,61 @@
+// Generación de claves de FV por fases: clave secreta, clave de evaluación y
+// clave pública. La clave de evaluación se genera con 1, 2, 4... hilos (los
+// pares de la clave son independientes) y s^2 se calcula una sola vez.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include "tools.h"
+#include "fv_params.hpp"
+
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "keygen.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+
+    // Número de hilos: 1, 2, 4, ... hasta los hilos hardware
+    std::vector<size_t> hilos;
+    size_t maximo = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    for (size_t h = 1; h < maximo; h *= 2) {
+        hilos.push_back(h);
+    }
+    hilos.push_back(maximo);
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (size_t n_hilos : hilos) {
+        FV::util::thread_pool pool(n_hilos);
+        for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+            std::chrono::high_resolution_clock::time_point start, finish;
+
+            start = std::chrono::high_resolution_clock::now();
+            FV::sk_t secret_key;
+            finish = std::chrono::high_resolution_clock::now();
+            double tiempo_sk = get_time_us(start, finish, 1);
+
+            start = std::chrono::high_resolution_clock::now();
+            FV::evk_t evaluation_key(secret_key, FV::params::word_size, FV::evk_options().threads(pool));
+            finish = std::chrono::high_resolution_clock::now();
+            double tiempo_evk = get_time_us(start, finish, 1);
+
+            start = std::chrono::high_resolution_clock::now();
+            FV::pk_t public_key(secret_key, evaluation_key);
+            finish = std::chrono::high_resolution_clock::now();
+            double tiempo_pk = get_time_us(start, finish, 1);
+
+            if (n_test == 0) {
+                std::cout << n_hilos << " hilos: sk " << tiempo_sk << " us, evk " << tiempo_evk << " us (" << evaluation_key.ell << " pares), pk " << tiempo_pk << " us" << std::endl;
+            }
+            datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << n_hilos << "," << tiempo_sk << "," << tiempo_evk << "," << tiempo_pk << "\n";
+        }
+    }
+    datos_csv.close();
+}
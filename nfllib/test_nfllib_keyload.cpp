@@ -0,0 +1,114 @@
+// Tiempo de arranque de un proceso que necesita las claves de FV: generarlas,
+// leerlas de disco (deserializar) o mapearlas con mmap (FV_io.hpp).
+// Al final se cifra y descifra con las claves mapeadas para comprobarlas.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "tools.h"
+#include "fv_params.hpp"
+#include "FV_io.hpp"
+
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "keyload.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+#define SK_FILE "fv_sk.bin"
+#define EVK_FILE "fv_evk.bin"
+#define PK_FILE "fv_pk.bin"
+
+int run_keyload(int n_test) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+
+    // Test 1: Generación de claves
+    start = std::chrono::high_resolution_clock::now();
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+    finish = std::chrono::high_resolution_clock::now();
+    double tiempo_generar = get_time_us(start, finish, 1);
+
+    FV::io::write(SK_FILE, secret_key);
+    FV::io::write(EVK_FILE, evaluation_key);
+    FV::io::write(PK_FILE, public_key);
+    size_t bytes_claves = FV::io::file_bytes(SK_FILE) + FV::io::file_bytes(EVK_FILE) +
+                          FV::io::file_bytes(PK_FILE);
+
+    // Test 2: Lectura de las claves desde disco
+    start = std::chrono::high_resolution_clock::now();
+    FV::sk_t sk_leida = FV::io::read_sk(SK_FILE);
+    std::unique_ptr<FV::evk_t> evk_leida = FV::io::read_evk(EVK_FILE);
+    std::unique_ptr<FV::pk_t> pk_leida = FV::io::read_pk(PK_FILE, *evk_leida);
+    finish = std::chrono::high_resolution_clock::now();
+    double tiempo_deserializar = get_time_us(start, finish, 1);
+
+    // Test 3: Mapeo de las claves con mmap
+    start = std::chrono::high_resolution_clock::now();
+    FV::sk_t sk_mapeada = FV::io::map_sk(SK_FILE);
+    std::unique_ptr<FV::evk_t> evk_mapeada = FV::io::map_evk(EVK_FILE);
+    std::unique_ptr<FV::pk_t> pk_mapeada = FV::io::map_pk(PK_FILE, *evk_mapeada);
+    finish = std::chrono::high_resolution_clock::now();
+    double tiempo_mmap = get_time_us(start, finish, 1);
+
+    // Comprobación: a*b con las claves mapeadas
+    FV::params::poly_p polinomios[2];
+    polinomios[0] = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    polinomios[1] = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    std::array<FV::ciphertext_t, 2> texto_cifrado;
+    FV::encrypt_poly(texto_cifrado[0], *pk_mapeada, polinomios[0]);
+    FV::encrypt_poly(texto_cifrado[1], *pk_mapeada, polinomios[1]);
+    FV::ciphertext_t mul_ab = texto_cifrado[0] * texto_cifrado[1];
+    std::array<mpz_t, N_COEF> plaintext_mul;
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_init(plaintext_mul[i]);
+    }
+    FV::decrypt_poly(plaintext_mul, sk_mapeada, *pk_mapeada, mul_ab);
+    // a*b mod (X^n+1, t), coeficiente a coeficiente
+    long a[] = {12,2345,65222,44,5913,65505,65,1987,65520,20}, b[] = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    std::vector<mpz_class> esperado(N_COEF, 0);
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            // X^n = -1
+            if (i + j < N_COEF) esperado[i + j] += mpz_class(a[i]) * b[j];
+            else esperado[i + j - N_COEF] -= mpz_class(a[i]) * b[j];
+        }
+    }
+    mpz_class t = FV::params::plaintextModulus<mpz_class>::value();
+    bool correcto = true;
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_class e = ((esperado[i] % t) + t) % t;
+        correcto = correcto && mpz_class(plaintext_mul[i]) == e;
+    }
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_clear(plaintext_mul[i]);
+    }
+    if (!correcto) {
+        std::cout << "Error: las claves mapeadas no descifran correctamente\n";
+        return 1;
+    }
+
+    std::cout << "Generar: " << tiempo_generar << " us, deserializar: " << tiempo_deserializar
+              << " us, mmap: " << tiempo_mmap << " us (" << bytes_claves / 1024 << " KiB)" << std::endl;
+
+    // Fin: Escribe resultados en csv
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << tiempo_generar << "," << tiempo_deserializar << "," << tiempo_mmap << "," << bytes_claves << "\n";
+    datos_csv.close();
+
+    return 0;
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    for (int i = 0; i < REPETICIONES; i++) {
+        if (run_keyload(i) != 0) return 1;
+    }
+    std::remove(SK_FILE);
+    std::remove(EVK_FILE);
+    std::remove(PK_FILE);
+}
@@ -0,0 +1,25 @@
+// Coste y ruido de FV por nivel de profundidad multiplicativa (include/profundidad.h):
+// cadenas de productos, árboles equilibrados y sumas de productos, hasta que
+// dejan de descifrar bien. El nivel de seguridad se fija en compilación
+// (-DSEC_LEVEL, ver fv_params.hpp).
+
+#include <exception>
+#include <iostream>
+#include "tools.h"
+#include "profundidad.h"
+#include "backend_nfllib.hpp"
+
+#define PROFUNDIDAD_MAXIMA 32 // Niveles de la cadena y de la suma de productos
+#define PROFUNDIDAD_ARBOL 5 // Niveles del árbol (2^5 hojas)
+#define TERMINOS 4 // Productos que se suman en cada nivel
+#define REPETICIONES 3 // Vamos a hacer 3 repeticiones por circuito
+#define CSV_FILE "profundidad.csv"
+
+int main() {
+    try {
+        return bench::ejecutar_profundidad<backend_nfllib>(CSV_FILE, SEC_LEVEL, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
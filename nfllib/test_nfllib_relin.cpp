@@ -0,0 +1,133 @@
+// Microbenchmark de la relinearización de FV: compara la clave de evaluación
+// repartida por el heap (P** con un new P[2] por par, como estaba antes) con el
+// bloque contiguo y alineado de evk_t, con y sin páginas grandes.
+// Además del tiempo se guardan fallos de caché y de TLB con perf_event_open.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "tools.h"
+#include "perf_counters.h"
+#include "fv_params.hpp"
+
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define N_RELIN 10 // Relinearizaciones completas (ell pares) por medida
+#define CSV_FILE "relin.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+using P = FV::params::poly_p;
+
+// Disposición antigua: un array de punteros a bloques new P[2] dispersos
+struct evk_disperso {
+    size_t ell;
+    P **values;
+    P **values_shoup;
+
+    explicit evk_disperso(FV::evk_t const& evk) : ell(evk.ell) {
+        values = (P **)malloc(ell * sizeof(P *));
+        values_shoup = (P **)malloc(ell * sizeof(P *));
+        for (size_t i = 0; i < ell; i++) {
+            values[i] = new P[2];
+            values_shoup[i] = new P[2];
+            FV::evk_t::value_type const* par = evk.pair(i);
+            for (size_t cm = 0; cm < P::nmoduli; cm++) {
+                for (size_t k = 0; k < P::degree; k++) {
+                    values[i][0](cm, k) = par[cm * P::degree + k];
+                    values[i][1](cm, k) = par[2 * FV::evk_t::poly_size + cm * P::degree + k];
+                }
+            }
+            values_shoup[i][0] = nfl::compute_shoup(values[i][0]);
+            values_shoup[i][1] = nfl::compute_shoup(values[i][1]);
+        }
+    }
+    ~evk_disperso() {
+        for (size_t i = 0; i < ell; i++) {
+            delete[] values[i];
+            delete[] values_shoup[i];
+        }
+        free(values);
+        free(values_shoup);
+    }
+
+    void accumulate(P &c0, P &c1, P const &c2i, size_t i) const {
+        c0 = c0 + nfl::shoup(c2i * values[i][0], values_shoup[i][0]);
+        c1 = c1 + nfl::shoup(c2i * values[i][1], values_shoup[i][1]);
+    }
+};
+
+bool iguales(P const& a, P const& b) {
+    for (size_t cm = 0; cm < P::nmoduli; cm++) {
+        for (size_t k = 0; k < P::degree; k++) {
+            if (a(cm, k) != b(cm, k)) return false;
+        }
+    }
+    return true;
+}
+
+// Recorre N_RELIN veces todos los pares de la clave y devuelve el tiempo por relinearización
+template <class EVK>
+double medir(EVK const& evk, std::vector<P> const& c2i, P &c0, P &c1, perf_counters &contadores) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    c0 = 0;
+    c1 = 0;
+    contadores.start();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < N_RELIN; r++) {
+        for (size_t i = 0; i < c2i.size(); i++) {
+            evk.accumulate(c0, c1, c2i[i], i);
+        }
+    }
+    finish = std::chrono::high_resolution_clock::now();
+    contadores.stop();
+    return get_time_us(start, finish, N_RELIN);
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::evk_t evaluation_key_huge(secret_key, FV::params::word_size, FV::evk_options().with_huge_pages());
+    evk_disperso evaluation_key_disperso(evaluation_key);
+
+    // Misma clave en la versión con páginas grandes para comparar solo la memoria
+    std::copy(evaluation_key.values.data(), evaluation_key.values.data() + evaluation_key.values.size(),
+              evaluation_key_huge.values.data());
+
+    // Descomposiciones c2i (ya en forma NTT) que se multiplican por la clave
+    std::vector<P> c2i(evaluation_key.ell);
+    for (size_t i = 0; i < c2i.size(); i++) {
+        c2i[i] = nfl::uniform();
+    }
+
+    std::cout << "Grado: " << N_COEF << ", ell: " << evaluation_key.ell << ", clave: "
+              << evaluation_key.values.size() * sizeof(FV::evk_t::value_type) / 1024 << " KiB"
+              << (evaluation_key_huge.values.mapped() ? " (reservada con mmap y páginas grandes)" : "") << std::endl;
+
+    perf_counters contadores({PERF_CICLOS, PERF_FALLOS_L1D, PERF_FALLOS_LLC, PERF_FALLOS_DTLB});
+    if (!contadores.disponible()) {
+        std::cout << "Aviso: contadores hardware no disponibles, se escribe -1" << std::endl;
+    }
+
+    P c0_disperso, c1_disperso, c0, c1;
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+        double tiempo_disperso = medir(evaluation_key_disperso, c2i, c0_disperso, c1_disperso, contadores);
+        datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << ",disperso," << tiempo_disperso << "," << contadores.valores_csv() << "\n";
+
+        double tiempo_plano = medir(evaluation_key, c2i, c0, c1, contadores);
+        datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << ",plano," << tiempo_plano << "," << contadores.valores_csv() << "\n";
+        if (!iguales(c0, c0_disperso) || !iguales(c1, c1_disperso)) {
+            std::cout << "Error: las dos disposiciones de la clave no dan el mismo resultado\n";
+            return 1;
+        }
+
+        double tiempo_huge = medir(evaluation_key_huge, c2i, c0, c1, contadores);
+        datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << ",plano_hugepages," << tiempo_huge << "," << contadores.valores_csv() << "\n";
+    }
+    datos_csv.close();
+}
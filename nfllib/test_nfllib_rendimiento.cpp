@@ -0,0 +1,86 @@
+// Rendimiento de FV con peticiones independientes en paralelo (rendimiento.h):
+// cada hilo saca su propio worker del contexto (FV_context.hpp) y atiende un
+// flujo de peticiones con las mismas claves. Una petición cifra dos mensajes,
+// los suma y los multiplica y descifra la suma y el producto. Se barre el
+// número de hilos desde 1 hasta los hilos hardware y se comprueba cada
+// resultado.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "tools.h"
+#include "rendimiento.h"
+#include "fv_params.hpp"
+#include "FV_context.hpp"
+
+#define PETICIONES 32 // Peticiones por hilo en cada medida
+#define REPETICIONES 5 // Medidas para cada número de hilos
+#define CSV_FILE "rendimiento.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+// Estado de un hilo: su worker y los polinomios de descifrado
+class flujo {
+public:
+    flujo(FV::context_t::worker_t worker, FV::sk_t const& secret_key, FV::pk_t const& public_key)
+        : worker_(std::move(worker)), secret_key_(secret_key), public_key_(public_key) {
+        for (size_t i = 0; i < N_COEF; i++) {
+            mpz_init(plaintext_[i]);
+        }
+    }
+    flujo(flujo const&) = delete;
+    flujo& operator=(flujo const&) = delete;
+    ~flujo() {
+        for (size_t i = 0; i < N_COEF; i++) {
+            mpz_clear(plaintext_[i]);
+        }
+    }
+
+    void operator()() {
+        FV::mess_t a, b;
+        a.random(worker_.rng);
+        b.random(worker_.rng);
+        FV::params::poly_p poly_a{a.getValue()}, poly_b{b.getValue()};
+        FV::ciphertext_t cifrado_a, cifrado_b;
+        FV::encrypt_poly(cifrado_a, public_key_, poly_a, worker_);
+        FV::encrypt_poly(cifrado_b, public_key_, poly_b, worker_);
+        FV::ciphertext_t suma = cifrado_a + cifrado_b;
+        FV::ciphertext_t producto = cifrado_a * cifrado_b;
+        FV::decrypt_poly(plaintext_, secret_key_, public_key_, suma);
+        if (mpz_class(plaintext_[0]) != (a + b).getValue()) {
+            throw std::runtime_error("la suma no descifra bien");
+        }
+        FV::decrypt_poly(plaintext_, secret_key_, public_key_, producto);
+        if (mpz_class(plaintext_[0]) != (a * b).getValue()) {
+            throw std::runtime_error("el producto no descifra bien");
+        }
+    }
+
+private:
+    FV::context_t::worker_t worker_;
+    FV::sk_t const& secret_key_;
+    FV::pk_t const& public_key_;
+    std::array<mpz_t, N_COEF> plaintext_;
+};
+
+int main() {
+    FV::context_t contexto;
+    FV::context_t::worker_t principal = contexto.fork();
+    FV::sk_t secret_key = FV::make_sk(principal);
+    std::unique_ptr<FV::evk_t> evaluation_key = FV::make_evk(principal, secret_key, FV::params::word_size);
+    std::unique_ptr<FV::pk_t> public_key = FV::make_pk(principal, secret_key, *evaluation_key);
+
+    try {
+        bench::barrido_rendimiento(CSV_FILE, LIBRERIA, std::to_string(SEC_LEVEL), REPETICIONES, PETICIONES, [&](size_t) {
+            std::shared_ptr<flujo> f = std::make_shared<flujo>(contexto.fork(), secret_key, *public_key);
+            return [f]() { (*f)(); };
+        });
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,111 @@
+// Muestreadores de FV: ruido gaussiano (sigma = 8) y polinomios uniformes.
+// Se comparan los de NFLlib (FastGaussianNoise y nfl::uniform) con los de
+// FV_prng.hpp sobre ChaCha20: la CDT muestra a muestra (antes) y rellenando el
+// polinomio entero por bloques vectorizables (después). Se mide muestras por
+// segundo y la latencia del cifrado con cada muestreador gaussiano.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include "tools.h"
+#include "fv_params.hpp"
+
+#define N_POLINOMIOS 100 // Polinomios por medida
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "samplers.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+using P = FV::params::poly_p;
+
+// CDT muestra a muestra, como antes de rellenar por bloques
+struct cdt_escalar {
+    FV::prng::cdt_gaussian &gauss;
+    void fill(P &p) {
+        for (size_t k = 0; k < P::degree; k++) {
+            int64_t e = gauss.next();
+            for (size_t cm = 0; cm < P::nmoduli; cm++) {
+                p(cm, k) = e >= 0 ? (uint64_t)e : P::get_modulus(cm) - (uint64_t)(-e);
+            }
+        }
+    }
+};
+
+// Tiempo en us de rellenar N_POLINOMIOS polinomios con muestrear(p, i)
+template <class F>
+double medir_muestreo(F muestrear) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    P p;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N_POLINOMIOS; i++) {
+        muestrear(p, i);
+    }
+    finish = std::chrono::high_resolution_clock::now();
+    return get_time_us(start, finish, 1);
+}
+
+// Latencia media en us de encrypt_poly con el ruido dado
+template <class N>
+double medir_cifrado(FV::pk_t const& public_key, N &ruido) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    P u;
+    FV::ciphertext_t cifrado;
+    double total = 0;
+    for (int i = 0; i < N_POLINOMIOS; i++) {
+        P m = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+        start = std::chrono::high_resolution_clock::now();
+        FV::encrypt_poly(cifrado, public_key, m, ruido, u);
+        finish = std::chrono::high_resolution_clock::now();
+        total += get_time_us(start, finish, 1);
+    }
+    return total / N_POLINOMIOS;
+}
+
+void escribir(std::ofstream &datos_csv, int n_test, char const* muestreador, double muestras_por_s, double t_cifrado) {
+    datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << muestreador << "," << muestras_por_s << "," << t_cifrado << "\n";
+    if (n_test == 0) {
+        std::cout << muestreador << ": " << muestras_por_s / 1e6 << " M muestras/s";
+        if (t_cifrado >= 0) std::cout << ", cifrado " << t_cifrado << " us";
+        std::cout << std::endl;
+    }
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+    FV::prng::seed_t semilla = FV::prng::fresh_seed();
+    FV::prng::cdt_gaussian gauss(semilla);
+    // El de NFLlib, aparte: los fg_prng_* de params usan por defecto la CDT
+    FV::params::gauss_t fast_gaussian(8.0, 128, 1 << 14);
+
+    double const gaussianas = (double)N_POLINOMIOS * P::degree * 1e6;
+    double const uniformes = gaussianas * P::nmoduli;
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+        // Ruido gaussiano: NFLlib, CDT escalar y CDT por bloques
+        auto ruido_nfllib = FV::util::global_noise(&fast_gaussian);
+        double t = medir_muestreo([&](P &p, int) { ruido_nfllib.fill(p); });
+        escribir(datos_csv, n_test, "gauss_nfllib", gaussianas / t, medir_cifrado(public_key, ruido_nfllib));
+
+        cdt_escalar ruido_escalar{gauss};
+        t = medir_muestreo([&](P &p, int) { ruido_escalar.fill(p); });
+        escribir(datos_csv, n_test, "cdt_escalar", gaussianas / t, medir_cifrado(public_key, ruido_escalar));
+
+        t = medir_muestreo([&](P &p, int) { gauss.fill(p); });
+        escribir(datos_csv, n_test, "cdt_vectorial", gaussianas / t, medir_cifrado(public_key, gauss));
+
+        // Polinomios uniformes: NFLlib y ChaCha20 con rechazo
+        t = medir_muestreo([&](P &p, int) { p = nfl::uniform(); });
+        escribir(datos_csv, n_test, "uniforme_nfllib", uniformes / t, -1);
+
+        t = medir_muestreo([&](P &p, int i) { FV::prng::uniform_poly(p, semilla, i); });
+        escribir(datos_csv, n_test, "uniforme_chacha", uniformes / t, -1);
+    }
+    datos_csv.close();
+}
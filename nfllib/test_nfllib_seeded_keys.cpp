@@ -0,0 +1,114 @@
+// Claves de FV comprimidas con semilla: la mitad uniforme de cada par de la
+// clave de evaluación (y la a de la clave pública) se guarda como 32 bytes y se
+// regenera con ChaCha20. Se compara la clave expandida al cargar con la que
+// regenera values[i][1] durante cada multiplicación: memoria, disco, tiempo de
+// carga y latencia de a*b.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include "tools.h"
+#include "fv_params.hpp"
+#include "FV_io.hpp"
+
+#define N_MULT 10 // Multiplicaciones por medida
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "seeded_keys.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+#define EVK_FILE "fv_evk_seeded.bin"
+#define EVK_FILE_COMPLETA "fv_evk_full.bin"
+
+// Descifra a*b con la clave de evaluación dada y devuelve el tiempo por multiplicación
+double medir_mult(FV::sk_t const& secret_key, FV::pk_t const& public_key, FV::evk_t const& evk,
+                  std::array<mpz_t, N_COEF> &plaintext_mul) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    FV::pk_t pk(evk, public_key.seed, public_key.b, public_key.b_shoup);
+    FV::params::poly_p polinomios[2];
+    polinomios[0] = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    polinomios[1] = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    std::array<FV::ciphertext_t, 2> texto_cifrado;
+    FV::encrypt_poly(texto_cifrado[0], pk, polinomios[0]);
+    FV::encrypt_poly(texto_cifrado[1], pk, polinomios[1]);
+    FV::ciphertext_t mul_ab;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N_MULT; i++) {
+        mul_ab = texto_cifrado[0] * texto_cifrado[1];
+    }
+    finish = std::chrono::high_resolution_clock::now();
+    FV::decrypt_poly(plaintext_mul, secret_key, pk, mul_ab);
+    return get_time_us(start, finish, N_MULT);
+}
+
+int run_seeded_keys(int n_test, std::ofstream &datos_csv) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+    FV::io::write(EVK_FILE, evaluation_key);
+    FV::io::write(EVK_FILE_COMPLETA, evaluation_key, false);
+
+    std::array<mpz_t, N_COEF> referencia, plaintext_mul;
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_inits(referencia[i], plaintext_mul[i], nullptr);
+    }
+    medir_mult(secret_key, public_key, evaluation_key, referencia);
+
+    struct modo_t {
+        char const *nombre;
+        char const *fichero;
+        bool mapear;
+        bool expandir;
+    };
+    modo_t modos[] = {
+        {"completa_mmap", EVK_FILE_COMPLETA, true, false},
+        {"semilla_expandida", EVK_FILE, false, true},
+        {"semilla_al_vuelo", EVK_FILE, true, false},
+    };
+    bool correcto = true;
+    for (modo_t const& modo : modos) {
+        start = std::chrono::high_resolution_clock::now();
+        std::unique_ptr<FV::evk_t> evk = modo.mapear ? FV::io::map_evk(modo.fichero, modo.expandir)
+                                                     : FV::io::read_evk(modo.fichero, modo.expandir);
+        finish = std::chrono::high_resolution_clock::now();
+        double tiempo_carga = get_time_us(start, finish, 1);
+
+        double tiempo_mult = medir_mult(secret_key, public_key, *evk, plaintext_mul);
+        for (size_t k = 0; k < N_COEF; k++) {
+            correcto = correcto && mpz_cmp(referencia[k], plaintext_mul[k]) == 0;
+        }
+
+        size_t bytes_memoria = evk->values.size() * sizeof(FV::evk_t::value_type);
+        size_t bytes_disco = FV::io::file_bytes(modo.fichero);
+        datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << modo.nombre << "," << bytes_memoria << "," << bytes_disco << "," << tiempo_carga << "," << tiempo_mult << "\n";
+        if (n_test == 0) {
+            std::cout << modo.nombre << ": " << bytes_memoria / 1024 << " KiB en memoria, " << bytes_disco / 1024
+                      << " KiB en disco, carga " << tiempo_carga << " us, a*b " << tiempo_mult << " us" << std::endl;
+        }
+    }
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_clears(referencia[i], plaintext_mul[i], nullptr);
+    }
+    if (!correcto) {
+        std::cout << "Error: las claves con semilla no dan el mismo a*b\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    int resultado = 0;
+    for (int i = 0; i < REPETICIONES && resultado == 0; i++) {
+        resultado = run_seeded_keys(i, datos_csv);
+    }
+    datos_csv.close();
+    std::remove(EVK_FILE);
+    std::remove(EVK_FILE_COMPLETA);
+    return resultado;
+}
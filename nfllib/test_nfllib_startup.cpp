@@ -0,0 +1,99 @@
+// Arranque de un proceso corto que usa FV: tiempo hasta main y hasta el primer
+// criptograma, con los cuatro FastGaussianNoise construidos antes de main (como
+// antes) o con muestreadores construidos al usarse sobre una tabla compartida
+// (FV_noise.hpp).
+// Se compila dos veces desde el Makefile: test_nfllib_startup (perezoso) y
+// test_nfllib_startup_eager (-DFV_EAGER_NOISE). Sin argumentos, lanza los dos
+// binarios como procesos hijos y mide el tiempo hasta que terminan (el otro
+// binario se busca junto a este, con /proc/self/exe):
+//   <binario> vacio   sale nada más entrar en main
+//   <binario> cifrar  genera las claves, cifra un polinomio y sale
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "tools.h"
+#include "fv_params.hpp"
+
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "startup.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+extern char **environ;
+
+// Lanza el binario con un argumento y devuelve el tiempo hasta que termina (us)
+double lanzar(std::string const& binario, char const* modo) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    char *argv[] = {const_cast<char *>(binario.c_str()), const_cast<char *>(modo), nullptr};
+    pid_t pid;
+    int estado;
+    start = std::chrono::high_resolution_clock::now();
+    if (posix_spawn(&pid, binario.c_str(), nullptr, nullptr, argv, environ) != 0) {
+        return -1;
+    }
+    waitpid(pid, &estado, 0);
+    finish = std::chrono::high_resolution_clock::now();
+    if (!WIFEXITED(estado) || WEXITSTATUS(estado) != 0) {
+        return -1;
+    }
+    return get_time_us(start, finish, 1);
+}
+
+// Ruta de este binario (argv[0] si no se puede leer /proc/self/exe), para
+// encontrar el otro aunque se lance desde el PATH o desde otro directorio
+std::string ruta_binario(char const* argv0) {
+    char ruta[4096];
+    ssize_t n = readlink("/proc/self/exe", ruta, sizeof(ruta) - 1);
+    if (n <= 0) {
+        return argv0;
+    }
+    return std::string(ruta, n);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::strcmp(argv[1], "vacio") == 0) {
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "cifrar") == 0) {
+        FV::sk_t secret_key;
+        FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+        FV::pk_t public_key(secret_key, evaluation_key);
+        FV::params::poly_p m = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+        FV::ciphertext_t cifrado;
+        FV::encrypt_poly(cifrado, public_key, m);
+        return 0;
+    }
+
+    std::string perezoso = ruta_binario(argv[0]);
+    std::string eager = perezoso + "_eager";
+    struct modo_t {
+        char const *nombre;
+        std::string const &binario;
+    };
+    modo_t modos[] = {{"eager", eager}, {"perezoso", perezoso}};
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+        for (modo_t const& modo : modos) {
+            double tiempo_arranque = lanzar(modo.binario, "vacio");
+            double tiempo_cifrado = lanzar(modo.binario, "cifrar");
+            if (tiempo_arranque < 0 || tiempo_cifrado < 0) {
+                std::cout << "Error: no se ha podido ejecutar " << modo.binario << "\n";
+                return 1;
+            }
+            if (n_test == 0) {
+                std::cout << modo.nombre << ": arranque " << tiempo_arranque << " us, primer cifrado " << tiempo_cifrado << " us" << std::endl;
+            }
+            datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << modo.nombre << "," << tiempo_arranque << "," << tiempo_cifrado << "\n";
+        }
+    }
+    datos_csv.close();
+}
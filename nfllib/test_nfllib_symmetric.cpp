@@ -0,0 +1,106 @@
+// Cifrado con clave pública frente a cifrado simétrico con semilla (c1 se
+// expande desde 32 bytes). Se mide el tiempo de cifrado, el de expandir el
+// criptograma en destino y los bytes que hay que guardar o enviar.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "tools.h"
+#include "fv_params.hpp"
+#include "FV_io.hpp"
+
+#define N_CIFRADOS 100 // Criptogramas por medida
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "symmetric.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+int run_symmetric(int n_test, FV::sk_t const& secret_key, FV::pk_t const& public_key) {
+    std::chrono::high_resolution_clock::time_point start, finish;
+    std::vector<FV::params::poly_p> mensajes(N_CIFRADOS);
+    for (int i = 0; i < N_CIFRADOS; i++) {
+        mensajes[i] = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    }
+
+    // Test 1: Cifrado con clave pública
+    std::vector<FV::ciphertext_t> cifrados_pk(N_CIFRADOS);
+    std::vector<FV::params::poly_p> m = mensajes;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N_CIFRADOS; i++) {
+        FV::encrypt_poly(cifrados_pk[i], public_key, m[i]);
+    }
+    finish = std::chrono::high_resolution_clock::now();
+    double tiempo_cifrado_pk = get_time_us(start, finish, N_CIFRADOS);
+
+    // Test 2: Cifrado con clave secreta y c1 como semilla
+    std::vector<FV::seeded_ciphertext_t> cifrados_sk(N_CIFRADOS);
+    m = mensajes;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N_CIFRADOS; i++) {
+        FV::encrypt_poly_symmetric(cifrados_sk[i], secret_key, public_key, m[i]);
+    }
+    finish = std::chrono::high_resolution_clock::now();
+    double tiempo_cifrado_sk = get_time_us(start, finish, N_CIFRADOS);
+
+    // Serialización para envío y expansión en el receptor
+    std::vector<uint8_t> buffer(N_CIFRADOS * FV::io::seeded_ciphertext_bytes);
+    for (int i = 0; i < N_CIFRADOS; i++) {
+        FV::io::serialize(buffer.data() + i * FV::io::seeded_ciphertext_bytes, cifrados_sk[i]);
+    }
+
+    // Test 3: Expansión de c1 desde la semilla
+    std::vector<FV::ciphertext_t> expandidos(N_CIFRADOS);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N_CIFRADOS; i++) {
+        FV::seeded_ciphertext_t recibido;
+        FV::io::deserialize(recibido, buffer.data() + i * FV::io::seeded_ciphertext_bytes, public_key);
+        recibido.expand(expandidos[i]);
+    }
+    finish = std::chrono::high_resolution_clock::now();
+    double tiempo_expandir = get_time_us(start, finish, N_CIFRADOS);
+
+    // Comprobación: los dos modos descifran al mismo mensaje
+    std::array<mpz_t, N_COEF> plaintext_pk, plaintext_sk;
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_inits(plaintext_pk[i], plaintext_sk[i], nullptr);
+    }
+    bool correcto = true;
+    for (int i = 0; i < N_CIFRADOS && correcto; i++) {
+        FV::decrypt_poly(plaintext_pk, secret_key, public_key, cifrados_pk[i]);
+        FV::decrypt_poly(plaintext_sk, secret_key, public_key, expandidos[i]);
+        for (size_t k = 0; k < N_COEF; k++) {
+            correcto = correcto && mpz_cmp(plaintext_pk[k], plaintext_sk[k]) == 0;
+        }
+    }
+    for (size_t i = 0; i < N_COEF; i++) {
+        mpz_clears(plaintext_pk[i], plaintext_sk[i], nullptr);
+    }
+    if (!correcto) {
+        std::cout << "Error: el cifrado simétrico no descifra al mismo mensaje\n";
+        return 1;
+    }
+
+    size_t bytes_pk = 2 * FV::io::poly_bytes;
+    size_t bytes_sk = FV::io::seeded_ciphertext_bytes;
+
+    // Fin: Escribe resultados en csv
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << tiempo_cifrado_pk << "," << tiempo_cifrado_sk << "," << tiempo_expandir << "," << bytes_pk << "," << bytes_sk << "\n";
+    datos_csv.close();
+
+    return 0;
+}
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    FV::sk_t secret_key;
+    FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+    FV::pk_t public_key(secret_key, evaluation_key);
+    for (int i = 0; i < REPETICIONES; i++) {
+        if (run_symmetric(i, secret_key, public_key) != 0) return 1;
+    }
+}
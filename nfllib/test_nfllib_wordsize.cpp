@@ -0,0 +1,96 @@
+// Barrido del tamaño de palabra de la clave de evaluación (FV::params::word_size)
+// entre 8 y 62 bits. Con palabras más pequeñas hay más pares (ell), la clave
+// ocupa más y la relinearización es más lenta, pero el ruido crece menos.
+// Para cada tamaño se mide la generación de la clave de evaluación, su tamaño,
+// la latencia de la multiplicación (con relinearización) y el ruido tras una
+// cadena de PROFUNDIDAD multiplicaciones, y se comprueba que descifra bien.
+// Al final se recomienda el tamaño más rápido que descifra bien a esa
+// profundidad. El nivel de seguridad se fija al compilar (-DSEC_LEVEL), el
+// Makefile genera un binario por nivel.
+
+#include <cstddef>
+#include <gmpxx.h>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "tools.h"
+#include "fv_params.hpp"
+
+#ifndef PROFUNDIDAD
+#define PROFUNDIDAD 2 // Multiplicaciones encadenadas que tienen que descifrar bien
+#endif
+#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
+#define CSV_FILE "wordsize.csv"
+#define LIBRERIA "nfllib" // Utilizada para saber a qué librería pertenece
+
+int main() {
+    // Semilla para valores deterministas
+    srand(0);
+    size_t const tamanos[] = {8, 12, 16, 20, 24, 28, 32, 40, 48, 56, 62};
+
+    FV::sk_t secret_key;
+    size_t mejor_tamano = 0;
+    double mejor_t_mul = 0;
+
+    std::ofstream datos_csv;
+    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
+    for (size_t tamano : tamanos) {
+        FV::params::word_size = tamano;
+        std::chrono::high_resolution_clock::time_point start, finish;
+
+        start = std::chrono::high_resolution_clock::now();
+        FV::evk_t evaluation_key(secret_key, FV::params::word_size);
+        finish = std::chrono::high_resolution_clock::now();
+        double tiempo_evk = get_time_us(start, finish, 1);
+        FV::pk_t public_key(secret_key, evaluation_key);
+        size_t bytes_evk = evaluation_key.values.size() * sizeof(FV::evk_t::value_type);
+
+        bool correcto = true;
+        double t_mul_total = 0;
+        for (int n_test = 0; n_test < REPETICIONES; n_test++) {
+            // Cadena m_0 * m_1 * ... * m_PROFUNDIDAD
+            FV::mess_t producto, mensaje;
+            producto.random();
+            FV::ciphertext_t cifrado, factor;
+            FV::encrypt(cifrado, public_key, producto);
+            size_t ruido_fresco = FV::noise(producto, secret_key, public_key, cifrado);
+
+            double tiempo_mul = 0;
+            for (int nivel = 0; nivel < PROFUNDIDAD; nivel++) {
+                mensaje.random();
+                FV::encrypt(factor, public_key, mensaje);
+                start = std::chrono::high_resolution_clock::now();
+                cifrado *= factor;
+                finish = std::chrono::high_resolution_clock::now();
+                tiempo_mul += get_time_us(start, finish, PROFUNDIDAD);
+                producto *= mensaje;
+            }
+            size_t ruido_final = FV::noise(producto, secret_key, public_key, cifrado);
+
+            FV::mess_t descifrado;
+            FV::decrypt(descifrado, secret_key, public_key, cifrado);
+            bool bien = descifrado.getValue() == producto.getValue();
+            correcto = correcto && bien;
+            t_mul_total += tiempo_mul;
+
+            if (n_test == 0) {
+                std::cout << "word_size " << tamano << " (ell " << evaluation_key.ell << "): evk " << bytes_evk / 1048576.0 << " MiB en " << tiempo_evk << " us, multiplicación " << tiempo_mul << " us, ruido " << ruido_fresco << " -> " << ruido_final << " bits" << (bien ? "" : ", NO descifra") << std::endl;
+            }
+            datos_csv << LIBRERIA << "," << n_test << "," << SEC_LEVEL << "," << N_COEF << "," << tamano << "," << evaluation_key.ell << "," << bytes_evk << "," << tiempo_evk << "," << tiempo_mul << "," << ruido_fresco << "," << ruido_final << "," << bien << "\n";
+        }
+
+        double t_mul = t_mul_total / REPETICIONES;
+        if (correcto && (mejor_tamano == 0 || t_mul < mejor_t_mul)) {
+            mejor_tamano = tamano;
+            mejor_t_mul = t_mul;
+        }
+    }
+    datos_csv.close();
+
+    if (mejor_tamano == 0) {
+        std::cout << "Ningún tamaño de palabra descifra bien a profundidad " << PROFUNDIDAD << std::endl;
+        return 1;
+    }
+    std::cout << "Recomendado para profundidad " << PROFUNDIDAD << ": word_size " << mejor_tamano << " (" << mejor_t_mul << " us por multiplicación)" << std::endl;
+}
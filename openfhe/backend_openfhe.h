@@ -0,0 +1,133 @@
+// Adaptador de BGV en OpenFHE para el benchmark común de include/backend.h.
+// Parámetros de test_openfhe_criptosistema.cpp: p = 65537, profundidad 2 (u
+// otra si se pide) y el nivel de seguridad cuántico que se pida. Los mensajes se empaquetan en las
+// ranuras (MakePackedPlaintext), así que el producto en claro es por ranuras.
+// EvalRotate gira a la izquierda dentro de cada fila de n/2 ranuras. OpenFHE
+// guarda las claves de evaluación en mapas estáticos: el destructor borra las
+// de la clave secreta del adaptador para que no se acumulen entre iteraciones.
+
+#pragma once
+
+#include "openfhe.h"
+#include "ciphertext-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include <cstddef>
+#include <limits>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class backend_openfhe {
+public:
+    using texto_plano = lbcrypto::Plaintext;
+    using cifrado = lbcrypto::Ciphertext<lbcrypto::DCRTPoly>;
+    using producto = lbcrypto::Ciphertext<lbcrypto::DCRTPoly>;
+    static constexpr bool rotacion = true;
+
+    static char const* nombre() { return "openfhe"; }
+
+    explicit backend_openfhe(int nivel_seguridad, int profundidad = 2) {
+        lbcrypto::CCParams<lbcrypto::CryptoContextBGVRNS> parameters;
+        parameters.SetMultiplicativeDepth(profundidad);
+        parameters.SetPlaintextModulus(p_);
+        parameters.SetSecurityLevel(nivel(nivel_seguridad));
+        cryptoContext_ = lbcrypto::GenCryptoContext(parameters);
+        cryptoContext_->Enable(lbcrypto::PKE);
+        cryptoContext_->Enable(lbcrypto::KEYSWITCH);
+        cryptoContext_->Enable(lbcrypto::LEVELEDSHE);
+    }
+
+    ~backend_openfhe() {
+        if (keyPair_.secretKey) {
+            std::string const etiqueta = keyPair_.secretKey->GetKeyTag();
+            lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>::ClearEvalMultKeys(etiqueta);
+            lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>::ClearEvalAutomorphismKeys(etiqueta);
+        }
+    }
+
+    backend_openfhe(backend_openfhe const&) = delete;
+    backend_openfhe& operator=(backend_openfhe const&) = delete;
+
+    void generar_claves() {
+        keyPair_ = cryptoContext_->KeyGen();
+        cryptoContext_->EvalMultKeyGen(keyPair_.secretKey);
+    }
+
+    void generar_claves_rotacion() {
+        cryptoContext_->EvalRotateKeyGen(keyPair_.secretKey, {1});
+    }
+
+    size_t ranuras() const { return cryptoContext_->GetRingDimension(); }
+    size_t grado() const { return cryptoContext_->GetRingDimension(); }
+    int64_t modulo() const { return p_; }
+
+    texto_plano codificar(std::vector<int64_t> const& valores) const {
+        return cryptoContext_->MakePackedPlaintext(valores);
+    }
+
+    cifrado cifrar(texto_plano&& mensaje) const {
+        return cryptoContext_->Encrypt(keyPair_.publicKey, mensaje);
+    }
+
+    cifrado sumar(cifrado const& a, cifrado const& b) const { return cryptoContext_->EvalAdd(a, b); }
+    producto multiplicar(cifrado const& a, cifrado const& b) const { return cryptoContext_->EvalMultNoRelin(a, b); }
+    cifrado relinealizar(producto p) const { return cryptoContext_->Relinearize(p); }
+    cifrado rotar(cifrado const& c, int pasos) const { return cryptoContext_->EvalRotate(c, pasos); }
+
+    // GetPackedValue da los valores centrados en (-p/2, p/2]
+    std::vector<int64_t> descifrar(cifrado const& c) const {
+        lbcrypto::Plaintext resultado;
+        cryptoContext_->Decrypt(keyPair_.secretKey, c, &resultado);
+        std::vector<int64_t> valores = resultado->GetPackedValue();
+        for (int64_t& v : valores) {
+            v = (v % p_ + p_) % p_;
+        }
+        return valores;
+    }
+
+    void serializar(cifrado const& c, std::ostream& salida) const {
+        lbcrypto::Serial::Serialize(c, salida, lbcrypto::SerType::BINARY);
+    }
+
+    // BGVRNS no da el ruido de un criptograma: cuando se acaban los niveles
+    // las operaciones lanzan una excepción
+    double presupuesto_ruido(cifrado const&, std::vector<int64_t> const&) const {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    std::vector<int64_t> producto_claro(std::vector<int64_t> const& a, std::vector<int64_t> const& b) const {
+        std::vector<int64_t> c(a.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            c[i] = a[i] * b[i] % p_;
+        }
+        return c;
+    }
+
+    std::vector<int64_t> rotacion_claro(std::vector<int64_t> const& valores, int pasos) const {
+        size_t const fila = ranuras() / 2;
+        std::vector<int64_t> todas(valores);
+        todas.resize(ranuras(), 0);
+        std::vector<int64_t> r(ranuras());
+        for (size_t i = 0; i < r.size(); i++) {
+            size_t inicio = i / fila * fila;
+            r[i] = todas[inicio + ((i - inicio + pasos) % fila + fila) % fila];
+        }
+        return r;
+    }
+
+private:
+    static lbcrypto::SecurityLevel nivel(int nivel_seguridad) {
+        switch (nivel_seguridad) {
+            case 128: return lbcrypto::HEStd_128_quantum;
+            case 192: return lbcrypto::HEStd_192_quantum;
+            case 256: return lbcrypto::HEStd_256_quantum;
+            default: throw std::invalid_argument("Nivel de seguridad inválido");
+        }
+    }
+
+    static constexpr int64_t p_ = 65537; // Módulo del texto plano
+    lbcrypto::CryptoContext<lbcrypto::DCRTPoly> cryptoContext_;
+    lbcrypto::KeyPair<lbcrypto::DCRTPoly> keyPair_;
+};
@@ -0,0 +1,20 @@
+// BGV en OpenFHE en el benchmark común de include/backend.h: las mismas fases y
+// la misma carga que test_nfllib_backend y test_helib_backend.
+
+#include <exception>
+#include <iostream>
+#include "tools.h"
+#include "backend.h"
+#include "backend_openfhe.h"
+
+int main() {
+    try {
+        int error = bench::ejecutar_backend<backend_openfhe>(128);
+        error |= bench::ejecutar_backend<backend_openfhe>(192);
+        error |= bench::ejecutar_backend<backend_openfhe>(256);
+        return error;
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,143 @@
+// Arranque en frío y en caliente de BGV en OpenFHE con la caché de contextos y
+// claves de include/cache_claves.h:
+//   T_frio      sin caché: GenCryptoContext, KeyGen y EvalMultKeysGen, y se
+//               guardan contexto, claves y clave de evaluación en la caché
+//   T_caliente  con caché: se deserializan de los ficheros
+// Antes de cada arranque se liberan los contextos y las claves de evaluación
+// que OpenFHE guarda en memoria, para que el proceso empiece como uno nuevo.
+// Con las claves cargadas se comprueba un producto. Al terminar la caché queda
+// completa para las siguientes ejecuciones.
+
+#include "openfhe.h"
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tools.h"
+#include "benchmark.h"
+#include "cache_claves.h"
+
+#ifndef VERSION_OPENFHE
+#define VERSION_OPENFHE "desconocida" // La pone el CMakeLists.txt
+#endif
+
+#define N_COEF 10 // Coeficiente de los polinomios
+#define CSV_FILE "he_cache.csv"
+#define CSV_RESUMEN "he_cache_resumen.csv"
+#define LIBRERIA "openfhe" // Utilizada para saber a qué librería pertenece
+
+struct conjunto_claves {
+    lbcrypto::CryptoContext<lbcrypto::DCRTPoly> cryptoContext;
+    lbcrypto::KeyPair<lbcrypto::DCRTPoly> keyPair;
+};
+
+// Olvida los contextos y las claves de evaluación que OpenFHE tiene en memoria
+void liberar() {
+    lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>::ClearEvalMultKeys();
+    lbcrypto::CryptoContextFactory<lbcrypto::DCRTPoly>::ReleaseAllContexts();
+}
+
+int run_bgv(lbcrypto::SecurityLevel security_level, int sec_level) {
+    int p = 65537; // Es el modulo de texto plano
+    int multDepth = 2; // Número de multiplicaciones que se pueden hacer
+    std::string entrada = cache::entrada(LIBRERIA, std::string("openfhe ") + VERSION_OPENFHE + " BGVRNS p=" + std::to_string(p) +
+                                                   " depth=" + std::to_string(multDepth) + " sec=" + std::to_string(sec_level));
+
+    std::function<conjunto_claves()> generar = [&]() {
+        lbcrypto::CCParams<lbcrypto::CryptoContextBGVRNS> parameters;
+        parameters.SetMultiplicativeDepth(multDepth);
+        parameters.SetPlaintextModulus(p);
+        parameters.SetSecurityLevel(security_level);
+        conjunto_claves c;
+        c.cryptoContext = lbcrypto::GenCryptoContext(parameters);
+        c.cryptoContext->Enable(lbcrypto::PKE);
+        c.cryptoContext->Enable(lbcrypto::LEVELEDSHE);
+        c.keyPair = c.cryptoContext->KeyGen();
+        c.cryptoContext->EvalMultKeysGen(c.keyPair.secretKey);
+        return c;
+    };
+    std::function<void(conjunto_claves const&)> guardar = [&](conjunto_claves const& c) {
+        std::ofstream evaluacion(entrada + "clave_evaluacion.bin", std::ios::binary);
+        if (!lbcrypto::Serial::SerializeToFile(entrada + "contexto.bin", c.cryptoContext, lbcrypto::SerType::BINARY) ||
+            !lbcrypto::Serial::SerializeToFile(entrada + "clave_publica.bin", c.keyPair.publicKey, lbcrypto::SerType::BINARY) ||
+            !lbcrypto::Serial::SerializeToFile(entrada + "clave_secreta.bin", c.keyPair.secretKey, lbcrypto::SerType::BINARY) ||
+            !c.cryptoContext->SerializeEvalMultKey(evaluacion, lbcrypto::SerType::BINARY)) {
+            throw std::runtime_error("no se puede escribir la caché en " + entrada);
+        }
+        // Un error al vaciar el búfer solo se ve al cerrar
+        evaluacion.close();
+        if (!evaluacion) {
+            throw std::runtime_error("no se puede escribir la caché en " + entrada);
+        }
+    };
+    std::function<conjunto_claves()> cargar = [&]() {
+        conjunto_claves c;
+        std::ifstream evaluacion(entrada + "clave_evaluacion.bin", std::ios::binary);
+        if (!lbcrypto::Serial::DeserializeFromFile(entrada + "contexto.bin", c.cryptoContext, lbcrypto::SerType::BINARY) ||
+            !lbcrypto::Serial::DeserializeFromFile(entrada + "clave_publica.bin", c.keyPair.publicKey, lbcrypto::SerType::BINARY) ||
+            !lbcrypto::Serial::DeserializeFromFile(entrada + "clave_secreta.bin", c.keyPair.secretKey, lbcrypto::SerType::BINARY) ||
+            !c.cryptoContext->DeserializeEvalMultKey(evaluacion, lbcrypto::SerType::BINARY)) {
+            throw std::runtime_error("no se puede leer la caché de " + entrada);
+        }
+        return c;
+    };
+
+    std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    bench::harness h({"T_frio", "T_caliente"});
+    while (h.siguiente()) {
+        bool cargado = false;
+        cache::borrar(entrada);
+        liberar();
+        h.start("T_frio");
+        conjunto_claves frio = cache::obtener(entrada, generar, guardar, cargar, &cargado);
+        h.stop("T_frio");
+
+        liberar();
+        h.start("T_caliente");
+        conjunto_claves caliente = cache::obtener(entrada, generar, guardar, cargar, &cargado);
+        h.stop("T_caliente");
+        if (!cargado) {
+            std::cout << "Error: la caché de " << entrada << " no se ha cargado\n";
+            return 1;
+        }
+
+        // Las claves cargadas tienen que servir para multiplicar y descifrar
+        lbcrypto::CryptoContext<lbcrypto::DCRTPoly> const& cryptoContext = caliente.cryptoContext;
+        auto ciphertext_a = cryptoContext->Encrypt(caliente.keyPair.publicKey, cryptoContext->MakePackedPlaintext(a));
+        auto ciphertext_b = cryptoContext->Encrypt(caliente.keyPair.publicKey, cryptoContext->MakePackedPlaintext(b));
+        lbcrypto::Plaintext plaintext_mul;
+        cryptoContext->Decrypt(caliente.keyPair.secretKey, cryptoContext->EvalMult(ciphertext_a, ciphertext_b), &plaintext_mul);
+        std::vector<int64_t> const& valores = plaintext_mul->GetPackedValue();
+        for (int i = 0; i < N_COEF; i++) {
+            if ((valores[i] % p + p) % p != a[i] * b[i] % p) {
+                std::cout << "Error: las claves de la caché no descifran bien\n";
+                return 1;
+            }
+        }
+        if (h.primera()) {
+            std::cout << "Caché de " << sec_level << " en " << entrada << std::endl;
+        }
+    }
+
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(sec_level));
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(sec_level));
+    return 0;
+}
+
+int main(){
+    try {
+        int error = run_bgv(lbcrypto::HEStd_128_quantum, 128);
+        error |= run_bgv(lbcrypto::HEStd_192_quantum, 192);
+        error |= run_bgv(lbcrypto::HEStd_256_quantum, 256);
+        return error;
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
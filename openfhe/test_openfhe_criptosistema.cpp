@@ -1,26 +1,92 @@
 #include "openfhe.h"
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/bgvrns/bgvrns-ser.h"
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
-#include <chrono>
+#include <string>
+#include <type_traits>
 #include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "tools.h"
+#include "benchmark.h"
+#include "memoria.h"
 
 #define N_COEF 10 // Coeficiente de los polinomios
-#define REPETICIONES 10 // Vamos a hacer 10 repeticiones por test
 #define CSV_FILE "he_schemes.csv"
+#define CSV_RESUMEN "he_schemes_resumen.csv"
+#define CSV_TAMANOS "tamanos.csv"
 #define LIBRERIA "openfhe" // Utilizada para saber a qué librería pertenece
 
 //using namespace lbcrypto;
 
-int run_bgv(int n_test, lbcrypto::SecurityLevel security_level) {
+// Esquemas que se miden: BGV y BFV con enteros módulo p en las ranuras y CKKS
+// con reales aproximados. Los tres con la misma profundidad, el mismo nivel de
+// seguridad y la misma dimensión del anillo, la mayor de las que elige OpenFHE
+// para cada uno (dimension_anillo()).
+using parametros_bgv = lbcrypto::CCParams<lbcrypto::CryptoContextBGVRNS>;
+using parametros_bfv = lbcrypto::CCParams<lbcrypto::CryptoContextBFVRNS>;
+using parametros_ckks = lbcrypto::CCParams<lbcrypto::CryptoContextCKKSRNS>;
+
+#define ESCALA_CKKS 50 // Bits del factor de escala de CKKS
+
+// Texto plano: módulo p en BGV y BFV, factor de escala en CKKS
+template <class Parametros>
+void configurar_texto(Parametros& parameters, int p) {
+    parameters.SetPlaintextModulus(p);
+}
+void configurar_texto(parametros_ckks& parameters, int) {
+    parameters.SetScalingModSize(ESCALA_CKKS);
+}
+
+// Parámetros comunes; ring_dim = 0 deja que OpenFHE elija la dimensión
+template <class Parametros>
+void configurar(Parametros& parameters, lbcrypto::SecurityLevel security_level, int multDepth, int p, uint32_t ring_dim) {
+    parameters.SetMultiplicativeDepth(multDepth);
+    parameters.SetSecurityLevel(security_level);
+    if (ring_dim != 0) {
+        parameters.SetRingDim(ring_dim);
+    }
+    configurar_texto(parameters, p);
+}
+
+// Dimensión del anillo que elige OpenFHE para el esquema
+template <class Parametros>
+uint32_t dimension_anillo(lbcrypto::SecurityLevel security_level, int multDepth, int p) {
+    Parametros parameters;
+    configurar(parameters, security_level, multDepth, p, 0);
+    return lbcrypto::GenCryptoContext(parameters)->GetRingDimension();
+}
+
+// CKKS codifica reales: los datos se pasan a [0, 1) dividiendo entre p para
+// que el producto de tres quepa con la escala
+lbcrypto::Plaintext codificar(lbcrypto::CryptoContext<lbcrypto::DCRTPoly> const& cryptoContext, bool ckks,
+                              std::vector<int64_t> const& valores, int p) {
+    if (!ckks) {
+        return cryptoContext->MakePackedPlaintext(valores);
+    }
+    std::vector<double> reales(valores.size());
+    for (size_t i = 0; i < valores.size(); i++) {
+        reales[i] = static_cast<double>(valores[i]) / p;
+    }
+    return cryptoContext->MakeCKKSPackedPlaintext(reales);
+}
+
+template <class Parametros>
+int run(lbcrypto::SecurityLevel security_level, std::string const& esquema, uint32_t ring_dim) {
 
     // Parámetros Los comentados es que no se usan en OpenFHE, los define internamente
     // int n = 32768; // Es la dimensión del anillo
     // int q; // Número de bits de primos q
-    int p = 65537; // Es el modulo de texto plano
+    int p = 65537; // Es el modulo de texto plano (no lo usa CKKS)
     int multDepth = 2; // Número de multiplicaciones que se pueden hacer
+    bool const ckks = std::is_same<Parametros, parametros_ckks>::value;
     int sec_level;
-    std::chrono::high_resolution_clock::time_point start, finish;
     switch(security_level){
       case lbcrypto::HEStd_128_quantum:
           sec_level = 128;
@@ -35,87 +101,138 @@ int run_bgv(int n_test, lbcrypto::SecurityLevel security_level) {
           std::cout << "Error: Nivel de seguridad no disponible\n";
           return -1;
     }
-    // Creo los polinomios que voy a multiplicar y sumar
-    std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
-    std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
-    std::vector<int64_t> c = {5,4321,65100,23,6789,65495,88,1024,65200,95};
-
-    // Test 0: Crea contexto
-    start = std::chrono::high_resolution_clock::now();
-    lbcrypto::CCParams<lbcrypto::CryptoContextBGVRNS> parameters;
-    parameters.SetMultiplicativeDepth(multDepth);
-    parameters.SetPlaintextModulus(p);
-    parameters.SetSecurityLevel(security_level);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_contexto= get_time_us(start, finish, 1);
-
-    lbcrypto::CryptoContext<lbcrypto::DCRTPoly> cryptoContext = lbcrypto::GenCryptoContext(parameters);
-    cryptoContext->Enable(lbcrypto::PKE);
-    cryptoContext->Enable(lbcrypto::LEVELEDSHE);
-
-    // Test 1: Generación de claves
-    lbcrypto::KeyPair<lbcrypto::DCRTPoly> keyPair;
-    start = std::chrono::high_resolution_clock::now();
-    keyPair = cryptoContext->KeyGen();
-    //Creo clave de evaluación. Si no no funciona
-    cryptoContext->EvalMultKeysGen(keyPair.secretKey);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_keygen = get_time_us(start, finish, 1); // Pongo 1 porque aunque hago dos claves, son un único set, sk y de evaluación
-
-    // Codifiación de los polinomios a texto plano
-    lbcrypto::Plaintext plaintext_a = cryptoContext->MakePackedPlaintext(a);
-    lbcrypto::Plaintext plaintext_b = cryptoContext->MakePackedPlaintext(b);
-    lbcrypto::Plaintext plaintext_c = cryptoContext->MakePackedPlaintext(c);
-
-    // Test 2: Cifrado de los criptogramas
-    start = std::chrono::high_resolution_clock::now();
-    auto ciphertext_a = cryptoContext->Encrypt(keyPair.publicKey, plaintext_a);
-    auto ciphertext_b = cryptoContext->Encrypt(keyPair.publicKey, plaintext_b);
-    auto ciphertext_c = cryptoContext->Encrypt(keyPair.publicKey, plaintext_c);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_cifrado = get_time_us(start, finish, 3);
-
-    // Test 3: Suma a+b+c
-    start = std::chrono::high_resolution_clock::now();
-    auto suma_ab = cryptoContext->EvalAdd(ciphertext_a, ciphertext_b);
-    auto suma_abc = cryptoContext->EvalAdd(suma_ab, ciphertext_c);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_suma = get_time_us(start, finish, 2);
-
-    // Test 4: Multiplicación a*b*c
-    start = std::chrono::high_resolution_clock::now();
-    auto mul_ab = cryptoContext->EvalMult(ciphertext_a, ciphertext_b);
-    auto mul_abc = cryptoContext->EvalMult(mul_ab, ciphertext_c);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_mul = get_time_us(start, finish, 2);
-
-    // Test 5: Descifrado
-    start = std::chrono::high_resolution_clock::now();
-    lbcrypto::Plaintext plaintext_suma, plaintext_mul;
-    cryptoContext->Decrypt(keyPair.secretKey, suma_abc, &plaintext_suma);
-    cryptoContext->Decrypt(keyPair.secretKey, mul_abc, &plaintext_mul);
-    finish = std::chrono::high_resolution_clock::now();
-    double tiempo_descifrado = get_time_us(start, finish, 2);
-
-    std::cout << "Polinomio a: " << plaintext_a << std::endl;
-    std::cout << "Polinomio b: " << plaintext_b << std::endl;
-    std::cout << "Polinomio c: " << plaintext_c << std::endl;
-    std::cout << "a + b + c: " << plaintext_suma << std::endl;
-    std::cout << "a * b * c: " << plaintext_mul << std::endl;
+    bench::harness h({"T_keygen", "T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado", "T_context"});
+    while (h.siguiente()) {
+        // Creo los polinomios que voy a multiplicar y sumar
+        std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+        std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+        std::vector<int64_t> c = {5,4321,65100,23,6789,65495,88,1024,65200,95};
+
+        // Test 0: Crea contexto
+        h.start("T_context");
+        Parametros parameters;
+        configurar(parameters, security_level, multDepth, p, ring_dim);
+        h.stop("T_context");
+
+        lbcrypto::CryptoContext<lbcrypto::DCRTPoly> cryptoContext = lbcrypto::GenCryptoContext(parameters);
+        cryptoContext->Enable(lbcrypto::PKE);
+        cryptoContext->Enable(lbcrypto::LEVELEDSHE);
+
+        // Con p = 65537 = 1 mod 2n cada coeficiente del anillo es una ranura;
+        // CKKS tiene n/2 ranuras complejas
+        size_t grado = cryptoContext->GetRingDimension();
+        size_t ranuras = ckks ? grado / 2 : grado;
+        if (h.llenar()) {
+            a = bench::datos_aleatorios(ranuras, p, 0);
+            b = bench::datos_aleatorios(ranuras, p, 1);
+            c = bench::datos_aleatorios(ranuras, p, 2);
+        }
+        h.carga(a.size(), ranuras, grado, {"T_cifardo", "T_suma", "T_multiplicacion", "T_descifrado"});
+
+        // Test 1: Generación de claves
+        lbcrypto::KeyPair<lbcrypto::DCRTPoly> keyPair;
+        h.start("T_keygen");
+        keyPair = cryptoContext->KeyGen();
+        //Creo clave de evaluación. Si no no funciona
+        cryptoContext->EvalMultKeysGen(keyPair.secretKey);
+        h.stop("T_keygen"); // Pongo 1 porque aunque hago dos claves, son un único set, sk y de evaluación
+
+        // Codifiación de los polinomios a texto plano
+        lbcrypto::Plaintext plaintext_a = codificar(cryptoContext, ckks, a, p);
+        lbcrypto::Plaintext plaintext_b = codificar(cryptoContext, ckks, b, p);
+        lbcrypto::Plaintext plaintext_c = codificar(cryptoContext, ckks, c, p);
+
+        // Test 2: Cifrado de los criptogramas
+        h.start("T_cifardo");
+        auto ciphertext_a = cryptoContext->Encrypt(keyPair.publicKey, plaintext_a);
+        auto ciphertext_b = cryptoContext->Encrypt(keyPair.publicKey, plaintext_b);
+        auto ciphertext_c = cryptoContext->Encrypt(keyPair.publicKey, plaintext_c);
+        h.stop("T_cifardo", 3);
+
+        // Test 3: Suma a+b+c
+        h.start("T_suma");
+        auto suma_ab = cryptoContext->EvalAdd(ciphertext_a, ciphertext_b);
+        auto suma_abc = cryptoContext->EvalAdd(suma_ab, ciphertext_c);
+        h.stop("T_suma", 2);
+
+        // Test 4: Multiplicación a*b*c
+        h.start("T_multiplicacion");
+        auto mul_ab = cryptoContext->EvalMult(ciphertext_a, ciphertext_b);
+        auto mul_abc = cryptoContext->EvalMult(mul_ab, ciphertext_c);
+        h.stop("T_multiplicacion", 2);
+
+        // Test 5: Descifrado
+        h.start("T_descifrado");
+        lbcrypto::Plaintext plaintext_suma, plaintext_mul;
+        cryptoContext->Decrypt(keyPair.secretKey, suma_abc, &plaintext_suma);
+        cryptoContext->Decrypt(keyPair.secretKey, mul_abc, &plaintext_mul);
+        h.stop("T_descifrado", 2);
+
+        // Tamaño del contexto, las claves y un criptograma serializados en binario
+        // (de BGV, el esquema que se compara con NFLlib y HElib en tamanos.csv)
+        if (h.primera() && esquema == "BGV") {
+            std::string grupo = std::to_string(sec_level);
+            memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "contexto", memoria::tamano_serializado([&](std::ostream& s) {
+                lbcrypto::Serial::Serialize(cryptoContext, s, lbcrypto::SerType::BINARY);
+            }));
+            memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_secreta", memoria::tamano_serializado([&](std::ostream& s) {
+                lbcrypto::Serial::Serialize(keyPair.secretKey, s, lbcrypto::SerType::BINARY);
+            }));
+            memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_publica", memoria::tamano_serializado([&](std::ostream& s) {
+                lbcrypto::Serial::Serialize(keyPair.publicKey, s, lbcrypto::SerType::BINARY);
+            }));
+            memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "clave_evaluacion", memoria::tamano_serializado([&](std::ostream& s) {
+                cryptoContext->SerializeEvalMultKey(s, lbcrypto::SerType::BINARY);
+            }));
+            memoria::escribir_tamano(CSV_TAMANOS, LIBRERIA, grupo, "criptograma", memoria::tamano_serializado([&](std::ostream& s) {
+                lbcrypto::Serial::Serialize(ciphertext_a, s, lbcrypto::SerType::BINARY);
+            }));
+        }
+
+        if (h.primera()) {
+            std::cout << "Esquema " << esquema << ", dimensión del anillo " << grado << std::endl;
+#ifdef _OPENMP
+            // Los tiempos dependen de los hilos de OpenMP (OMP_NUM_THREADS); el barrido está en test_openfhe_hilos
+            std::cout << "Hilos de OpenMP: " << omp_get_max_threads() << std::endl;
+#endif
+            if (h.llenar()) {
+                for (lbcrypto::Plaintext* plaintext : {&plaintext_a, &plaintext_b, &plaintext_c, &plaintext_suma, &plaintext_mul}) {
+                    (*plaintext)->SetLength(N_COEF);
+                }
+            }
+            std::cout << "Polinomio a: " << plaintext_a << std::endl;
+            std::cout << "Polinomio b: " << plaintext_b << std::endl;
+            std::cout << "Polinomio c: " << plaintext_c << std::endl;
+            std::cout << "a + b + c: " << plaintext_suma << std::endl;
+            std::cout << "a * b * c: " << plaintext_mul << std::endl;
+        }
+
+        // OpenFHE guarda las claves de evaluación en un mapa estático: se borran
+        // para que no se acumulen de una iteración a otra
+        lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>::ClearEvalMultKeys(keyPair.secretKey->GetKeyTag());
+    }
 
     // Fin: Escribe resultados en csv
-    std::ofstream datos_csv;
-    datos_csv.open(CSV_FILE, std::ios::out | std::ios::app);
-    datos_csv << LIBRERIA << "," << n_test << "," << sec_level << "," << tiempo_keygen << "," << tiempo_cifrado << "," << tiempo_suma << "," << tiempo_mul << "," << tiempo_descifrado << "," << tiempo_contexto << "\n";
-    datos_csv.close();
+    h.escribir_iteraciones(CSV_FILE, LIBRERIA, std::to_string(sec_level) + "," + esquema);
+    h.escribir_resumen(CSV_RESUMEN, LIBRERIA, std::to_string(sec_level) + "," + esquema);
 
     return 0;
 }
 
+// Los tres esquemas con la misma dimensión del anillo
+void run_esquemas(lbcrypto::SecurityLevel security_level) {
+    int p = 65537;
+    int multDepth = 2;
+    uint32_t ring_dim = std::max({dimension_anillo<parametros_bgv>(security_level, multDepth, p),
+                                  dimension_anillo<parametros_bfv>(security_level, multDepth, p),
+                                  dimension_anillo<parametros_ckks>(security_level, multDepth, p)});
+    run<parametros_bgv>(security_level, "BGV", ring_dim);
+    run<parametros_bfv>(security_level, "BFV", ring_dim);
+    run<parametros_ckks>(security_level, "CKKS", ring_dim);
+}
+
 int main(){
-  for(int i = 0; i<REPETICIONES; i++){
-      run_bgv(i, lbcrypto::HEStd_128_quantum);
-      run_bgv(i, lbcrypto::HEStd_192_quantum);
-      run_bgv(i, lbcrypto::HEStd_256_quantum);
-  }
+  run_esquemas(lbcrypto::HEStd_128_quantum);
+  run_esquemas(lbcrypto::HEStd_192_quantum);
+  run_esquemas(lbcrypto::HEStd_256_quantum);
 }
\ No newline at end of file
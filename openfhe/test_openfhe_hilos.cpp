@@ -0,0 +1,129 @@
+// Barrido del número de hilos de OpenMP en BGV de OpenFHE, que reparte entre
+// hilos el trabajo de las torres RNS. Para 1, 2, 4... hasta los hilos hardware
+// (omp_set_num_threads) se miden KeyGen, EvalMultKeysGen, Encrypt, EvalAdd,
+// EvalMult y Decrypt con el harness de include/benchmark.h. El número de hilos
+// va en la columna Hilos de los CSV y al terminar cada nivel se muestra la
+// aceleración de cada operación frente a un hilo. Sin OpenMP solo se mide un
+// hilo. Los contadores hardware (BENCH_PERF) se desactivan: perf_counters.h
+// solo cuenta el hilo que llama y no los hilos de OpenMP, así que con más de
+// un hilo las columnas saldrían muy por debajo. Las claves de evaluación se
+// borran al final de cada iteración; OpenFHE las guarda en un mapa estático y
+// si no el heap crecería a lo largo del barrido.
+
+#include "openfhe.h"
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "tools.h"
+#include "benchmark.h"
+#include "rendimiento.h"
+
+#define N_COEF 10 // Coeficiente de los polinomios
+#define CSV_FILE "openfhe_hilos.csv"
+#define CSV_RESUMEN "openfhe_hilos_resumen.csv"
+#define LIBRERIA "openfhe" // Utilizada para saber a qué librería pertenece
+
+int run_bgv(lbcrypto::SecurityLevel security_level, int sec_level) {
+    int p = 65537; // Es el modulo de texto plano
+    int multDepth = 2; // Número de multiplicaciones que se pueden hacer
+    lbcrypto::CCParams<lbcrypto::CryptoContextBGVRNS> parameters;
+    parameters.SetMultiplicativeDepth(multDepth);
+    parameters.SetPlaintextModulus(p);
+    parameters.SetSecurityLevel(security_level);
+    lbcrypto::CryptoContext<lbcrypto::DCRTPoly> cryptoContext = lbcrypto::GenCryptoContext(parameters);
+    cryptoContext->Enable(lbcrypto::PKE);
+    cryptoContext->Enable(lbcrypto::LEVELEDSHE);
+
+    std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    lbcrypto::Plaintext plaintext_a = cryptoContext->MakePackedPlaintext(a);
+    lbcrypto::Plaintext plaintext_b = cryptoContext->MakePackedPlaintext(b);
+
+#ifdef _OPENMP
+    std::vector<size_t> barrido = bench::hilos_hasta_nucleos();
+    omp_set_dynamic(0);
+    int hilos_por_defecto = omp_get_max_threads();
+#else
+    std::vector<size_t> barrido = {1};
+    std::cerr << "OpenFHE sin OpenMP: solo se mide con un hilo\n";
+#endif
+    std::map<std::string, double> un_hilo; // Mediana con un hilo de cada fase
+    bench::config sin_contadores = bench::config::entorno();
+    if (sin_contadores.contadores) {
+        std::cerr << "BENCH_PERF no se usa en el barrido de hilos (los contadores no siguen a los hilos de OpenMP)\n";
+        sin_contadores.contadores = false;
+    }
+    for (size_t hilos : barrido) {
+#ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(hilos));
+#endif
+        std::string grupo = std::to_string(sec_level) + "," + std::to_string(hilos);
+        bench::harness h({"T_keygen", "T_evalmultkey", "T_cifrado", "T_suma", "T_multiplicacion", "T_descifrado"}, sin_contadores);
+        while (h.siguiente()) {
+            h.start("T_keygen");
+            lbcrypto::KeyPair<lbcrypto::DCRTPoly> keyPair = cryptoContext->KeyGen();
+            h.stop("T_keygen");
+
+            h.start("T_evalmultkey");
+            cryptoContext->EvalMultKeysGen(keyPair.secretKey);
+            h.stop("T_evalmultkey");
+
+            h.start("T_cifrado");
+            auto ciphertext_a = cryptoContext->Encrypt(keyPair.publicKey, plaintext_a);
+            auto ciphertext_b = cryptoContext->Encrypt(keyPair.publicKey, plaintext_b);
+            h.stop("T_cifrado", 2);
+
+            h.start("T_suma");
+            auto suma = cryptoContext->EvalAdd(ciphertext_a, ciphertext_b);
+            h.stop("T_suma");
+
+            h.start("T_multiplicacion");
+            auto producto = cryptoContext->EvalMult(ciphertext_a, ciphertext_b);
+            h.stop("T_multiplicacion");
+
+            h.start("T_descifrado");
+            lbcrypto::Plaintext plaintext_suma, plaintext_mul;
+            cryptoContext->Decrypt(keyPair.secretKey, suma, &plaintext_suma);
+            cryptoContext->Decrypt(keyPair.secretKey, producto, &plaintext_mul);
+            h.stop("T_descifrado", 2);
+
+            std::vector<int64_t> const& valores = plaintext_mul->GetPackedValue();
+            for (int i = 0; i < N_COEF; i++) {
+                if ((valores[i] % p + p) % p != a[i] * b[i] % p) {
+                    std::cout << "Error: el producto no descifra bien con " << hilos << " hilos\n";
+                    return 1;
+                }
+            }
+            lbcrypto::CryptoContextImpl<lbcrypto::DCRTPoly>::ClearEvalMultKeys();
+        }
+        h.escribir_iteraciones(CSV_FILE, LIBRERIA, grupo);
+        h.escribir_resumen(CSV_RESUMEN, LIBRERIA, grupo);
+
+        // Aceleración frente a un hilo
+        std::cout << sec_level << " con " << hilos << " hilos:";
+        for (std::string const& fase : h.fases()) {
+            double mediana = h.resumen(fase).mediana;
+            if (hilos == 1) {
+                un_hilo[fase] = mediana;
+            }
+            std::cout << " " << fase << " x" << un_hilo[fase] / mediana;
+        }
+        std::cout << std::endl;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(hilos_por_defecto);
+#endif
+    return 0;
+}
+
+int main(){
+    int error = run_bgv(lbcrypto::HEStd_128_quantum, 128);
+    error |= run_bgv(lbcrypto::HEStd_192_quantum, 192);
+    error |= run_bgv(lbcrypto::HEStd_256_quantum, 256);
+    return error;
+}
@@ -0,0 +1,28 @@
+// Coste por nivel de profundidad multiplicativa de BGV en OpenFHE
+// (include/profundidad.h): cadenas de productos, árboles equilibrados y sumas
+// de productos. El contexto se crea para PROFUNDIDAD_MAXIMA niveles; BGVRNS no
+// da el presupuesto de ruido, así que esa columna queda vacía.
+
+#include <exception>
+#include <iostream>
+#include "tools.h"
+#include "profundidad.h"
+#include "backend_openfhe.h"
+
+#define PROFUNDIDAD_MAXIMA 8 // Niveles de la cadena y de la suma de productos
+#define PROFUNDIDAD_ARBOL 5 // Niveles del árbol (2^5 hojas)
+#define TERMINOS 4 // Productos que se suman en cada nivel
+#define REPETICIONES 3 // Vamos a hacer 3 repeticiones por circuito
+#define CSV_FILE "profundidad.csv"
+
+int main() {
+    try {
+        int error = bench::ejecutar_profundidad<backend_openfhe>(CSV_FILE, 128, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+        error |= bench::ejecutar_profundidad<backend_openfhe>(CSV_FILE, 192, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+        error |= bench::ejecutar_profundidad<backend_openfhe>(CSV_FILE, 256, PROFUNDIDAD_MAXIMA, PROFUNDIDAD_ARBOL, TERMINOS, REPETICIONES);
+        return error;
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,84 @@
+// Rendimiento de BGV en OpenFHE con peticiones independientes en paralelo
+// (rendimiento.h): los hilos comparten el contexto y las claves y cada uno
+// atiende un flujo de peticiones. Una petición cifra dos vectores, los suma y
+// los multiplica y descifra la suma y el producto. Cada hilo usa un solo hilo de OpenMP
+// para que el paralelismo sea solo el de las peticiones.
+
+#include "openfhe.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "tools.h"
+#include "rendimiento.h"
+
+#define N_COEF 10 // Coeficiente de los polinomios
+#define PETICIONES 8 // Peticiones por hilo en cada medida
+#define REPETICIONES 5 // Medidas para cada número de hilos
+#define CSV_FILE "rendimiento.csv"
+#define LIBRERIA "openfhe" // Utilizada para saber a qué librería pertenece
+
+int run_bgv(lbcrypto::SecurityLevel security_level, int sec_level) {
+    int p = 65537; // Es el modulo de texto plano
+    int multDepth = 2; // Número de multiplicaciones que se pueden hacer
+    lbcrypto::CCParams<lbcrypto::CryptoContextBGVRNS> parameters;
+    parameters.SetMultiplicativeDepth(multDepth);
+    parameters.SetPlaintextModulus(p);
+    parameters.SetSecurityLevel(security_level);
+    lbcrypto::CryptoContext<lbcrypto::DCRTPoly> cryptoContext = lbcrypto::GenCryptoContext(parameters);
+    cryptoContext->Enable(lbcrypto::PKE);
+    cryptoContext->Enable(lbcrypto::LEVELEDSHE);
+    lbcrypto::KeyPair<lbcrypto::DCRTPoly> keyPair = cryptoContext->KeyGen();
+    cryptoContext->EvalMultKeysGen(keyPair.secretKey);
+
+    std::vector<int64_t> a = {12,2345,65222,44,5913,65505,65,1987,65520,20};
+    std::vector<int64_t> b = {11,3690,65535,35,8765,65490,89,9012,65530,10};
+    std::vector<int64_t> esperado_suma(N_COEF), esperado(N_COEF);
+    for (int i = 0; i < N_COEF; i++) {
+        esperado_suma[i] = (a[i] + b[i]) % p;
+        esperado[i] = a[i] * b[i] % p;
+    }
+
+    try {
+        bench::barrido_rendimiento(CSV_FILE, LIBRERIA, std::to_string(sec_level), REPETICIONES, PETICIONES, [&](size_t) {
+#ifdef _OPENMP
+            omp_set_num_threads(1);
+#endif
+            return [&]() {
+                lbcrypto::Plaintext plaintext_a = cryptoContext->MakePackedPlaintext(a);
+                lbcrypto::Plaintext plaintext_b = cryptoContext->MakePackedPlaintext(b);
+                auto ciphertext_a = cryptoContext->Encrypt(keyPair.publicKey, plaintext_a);
+                auto ciphertext_b = cryptoContext->Encrypt(keyPair.publicKey, plaintext_b);
+                auto suma = cryptoContext->EvalAdd(ciphertext_a, ciphertext_b);
+                auto producto = cryptoContext->EvalMult(ciphertext_a, ciphertext_b);
+                lbcrypto::Plaintext plaintext_suma, plaintext_producto;
+                cryptoContext->Decrypt(keyPair.secretKey, suma, &plaintext_suma);
+                cryptoContext->Decrypt(keyPair.secretKey, producto, &plaintext_producto);
+                std::vector<int64_t> const& valores_suma = plaintext_suma->GetPackedValue();
+                std::vector<int64_t> const& valores = plaintext_producto->GetPackedValue();
+                for (int i = 0; i < N_COEF; i++) {
+                    if ((valores_suma[i] % p + p) % p != esperado_suma[i]) {
+                        throw std::runtime_error("la suma no descifra bien");
+                    }
+                    if ((valores[i] % p + p) % p != esperado[i]) {
+                        throw std::runtime_error("el producto no descifra bien");
+                    }
+                }
+            };
+        });
+    } catch (std::exception const& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(){
+    int error = run_bgv(lbcrypto::HEStd_128_quantum, 128);
+    error |= run_bgv(lbcrypto::HEStd_192_quantum, 192);
+    error |= run_bgv(lbcrypto::HEStd_256_quantum, 256);
+    return error;
+}
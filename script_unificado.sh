@@ -2,13 +2,50 @@
 
 polinomios_csv="statistics.csv"
 esquemas_csv="he_schemes.csv"
+# Resumen de cada fase (include/benchmark.h): mediana con intervalo del 95%, percentiles y atípicos
+# Con BENCH_PERF=1 se rellenan también las columnas de contadores hardware (mediana por operación)
+# y con BENCH_MEMORIA=1 las de memoria. Mediana_por_elemento es el coste por elemento útil del texto plano
+# (vacía en las fases de contexto y claves);
+# con BENCH_LLENAR=1 los benchmarks de esquemas llenan todas las ranuras
+polinomios_resumen_csv="statistics_resumen.csv"
+esquemas_resumen_csv="he_schemes_resumen.csv"
+# Tamaño serializado de contexto, claves y criptogramas de cada librería
+tamanos_csv="tamanos.csv"
+# Benchmark común de los tres esquemas con las mismas fases (include/backend.h)
+backend_csv="backend.csv"
+backend_resumen_csv="backend_resumen.csv"
+# Tiempo y presupuesto de ruido por nivel de profundidad (include/profundidad.h)
+profundidad_csv="profundidad.csv"
+# Arranque sin caché de contexto y claves (T_frio) y cargándolos de la caché (T_caliente), include/cache_claves.h
+cache_csv="he_cache.csv"
+cache_resumen_csv="he_cache_resumen.csv"
+# Barrido de hilos de OpenMP en OpenFHE (test_openfhe_hilos)
+hilos_csv="openfhe_hilos.csv"
+hilos_resumen_csv="openfhe_hilos_resumen.csv"
+# Peticiones por segundo con peticiones independientes en paralelo (include/rendimiento.h)
+rendimiento_csv="rendimiento.csv"
 cabeceras_poly=("Libreria,Iteracion,Tamano_Mod,T_polinomio,T_NTT,T_suma,T_multiplicacion,T_INTT")
-cabeceras_scheme=("Libreria,Iteracion,Sec_Level,T_keygen,T_cifardo,T_suma,T_multiplicacion,T_descifrado,T_context")
-tests_librerias=("./test_nfllib" "./test_openfhe" "./test_helib" "./test_nfllib_criptosistema_128" "./test_nfllib_criptosistema_192" "./test_nfllib_criptosistema_256" "./test_openfhe_criptosistema" "./test_helib_criptosistema")
+cabeceras_scheme=("Libreria,Iteracion,Sec_Level,Esquema,T_keygen,T_cifardo,T_suma,T_multiplicacion,T_descifrado,T_context")
+cabeceras_backend=("Libreria,Iteracion,Sec_Level,T_context,T_keygen,T_claves_rotacion,T_codificar,T_cifrado,T_suma,T_multiplicacion,T_relinealizacion,T_rotacion,T_descifrado,T_serializacion")
+cabeceras_resumen="Fase,N,Media,Desviacion,Mediana,IC95_inf,IC95_sup,P90,P99,Atipicos,Mediana_ciclos,Ciclos_hw,Instrucciones,Fallos_L1D,Fallos_LLC,Fallos_salto,Fallos_DTLB,Reservas,Bytes_reservados,Pico_heap,Pico_RSS_kB,Elementos,Ranuras,Grado,Mediana_por_elemento"
+tests_librerias=("./test_nfllib" "./test_openfhe" "./test_helib" "./test_nfllib_criptosistema_128" "./test_nfllib_criptosistema_192" "./test_nfllib_criptosistema_256" "./test_nfllib_criptosistema_auto" "./test_openfhe_criptosistema" "./test_helib_criptosistema" "./test_nfllib_backend_128" "./test_nfllib_backend_192" "./test_nfllib_backend_256" "./test_openfhe_backend" "./test_helib_backend" "./test_nfllib_profundidad_128" "./test_nfllib_profundidad_192" "./test_nfllib_profundidad_256" "./test_openfhe_profundidad" "./test_helib_profundidad" "./test_openfhe_cache" "./test_helib_cache" "./test_openfhe_hilos" "./test_nfllib_rendimiento" "./test_openfhe_rendimiento" "./test_helib_rendimiento")
 
 echo $cabeceras_poly > $polinomios_csv
 echo $cabeceras_scheme > $esquemas_csv
+echo "Libreria,Tamano_Mod,$cabeceras_resumen" > $polinomios_resumen_csv
+echo "Libreria,Sec_Level,Esquema,$cabeceras_resumen" > $esquemas_resumen_csv
+echo "Libreria,Sec_Level,Objeto,Bytes" > $tamanos_csv
+echo $cabeceras_backend > $backend_csv
+echo "Libreria,Sec_Level,$cabeceras_resumen" > $backend_resumen_csv
+echo "Libreria,Iteracion,Sec_Level,Circuito,Nivel,T_nivel,Presupuesto_bits,Correcto" > $profundidad_csv
+echo "Libreria,Iteracion,Sec_Level,T_frio,T_caliente" > $cache_csv
+echo "Libreria,Sec_Level,$cabeceras_resumen" > $cache_resumen_csv
+echo "Libreria,Iteracion,Sec_Level,Hilos,T_keygen,T_evalmultkey,T_cifrado,T_suma,T_multiplicacion,T_descifrado" > $hilos_csv
+echo "Libreria,Sec_Level,Hilos,$cabeceras_resumen" > $hilos_resumen_csv
+echo "Libreria,Iteracion,Sec_Level,Hilos,Peticiones_por_s,Eficiencia,Lat_mediana_us,Lat_p90_us,Lat_p99_us,Peor_p99_hilo_us" > $rendimiento_csv
 
+# Se salta lo que no se ha compilado (test_nfllib_criptosistema_auto solo lo compila make nfllib_auto)
 for libreria in ${tests_librerias[@]}; do 
+    [ -x "$libreria" ] || continue
     $libreria
 done
\ No newline at end of file